@@ -0,0 +1,96 @@
+// Writes the map in src/map.ts as the server's binary map file (see
+// server/addon/map_file.h), baking the collider grids the server would build.
+//
+// Usage: node --experimental-strip-types scripts/exportMap.ts [out]   (Node 22.6+)
+// Default out: ../server/maps/city.bfmap
+import { writeFileSync, renameSync } from "node:fs";
+import { ALL_WALLS, PLATFORM_RECTS, SPAWN_POINTS, WORLD_HALF } from "../src/map.ts";
+
+const MAGIC = 0x504d4642; // "BFMP"
+const VERSION = 1;
+const CELL_SIZE = 4;
+const HEADER_BYTES = 40;
+
+type Box = [number, number, number, number]; // minX, maxX, minZ, maxZ
+
+const f32 = Math.fround;
+
+// ColliderGrid's cell lists, computed in float32 like the server does so a
+// collider lands in exactly the cells the server would put it in.
+function bakeGrid(boxes: Box[], half: number, cellSize: number): { cellStart: Uint32Array; items: Uint32Array } {
+  const inv = f32(1 / cellSize);
+  const dim = cellsPerSide(half, cellSize);
+  const cell = (v: number) => Math.max(0, Math.min(dim - 1, Math.floor(f32(f32(f32(v) + f32(half)) * inv))));
+  const cellStart = new Uint32Array(dim * dim + 1);
+  for (const [minX, maxX, minZ, maxZ] of boxes) {
+    for (let cz = cell(minZ); cz <= cell(maxZ); ++cz) {
+      for (let cx = cell(minX); cx <= cell(maxX); ++cx) ++cellStart[cz * dim + cx + 1];
+    }
+  }
+  for (let c = 0; c < dim * dim; ++c) cellStart[c + 1] += cellStart[c];
+  const items = new Uint32Array(cellStart[dim * dim]);
+  const fill = cellStart.slice(0, dim * dim);
+  boxes.forEach(([minX, maxX, minZ, maxZ], i) => {
+    for (let cz = cell(minZ); cz <= cell(maxZ); ++cz) {
+      for (let cx = cell(minX); cx <= cell(maxX); ++cx) items[fill[cz * dim + cx]++] = i;
+    }
+  });
+  return { cellStart, items };
+}
+
+function cellsPerSide(half: number, cellSize: number): number {
+  return Math.max(1, Math.ceil(f32(f32(2 * f32(half)) * f32(1 / cellSize))));
+}
+
+export function encodeMap(): Uint8Array {
+  const walls: Box[] = ALL_WALLS.map(([minX, maxX, minZ, maxZ]) => [minX, maxX, minZ, maxZ]);
+  const platforms = PLATFORM_RECTS;
+  const wallGrid = bakeGrid(walls, WORLD_HALF, CELL_SIZE);
+  const platformGrid = bakeGrid(
+    platforms.map((p): Box => [p.minX, p.maxX, p.minZ, p.maxZ]),
+    WORLD_HALF,
+    CELL_SIZE,
+  );
+  const size =
+    HEADER_BYTES +
+    walls.length * 16 +
+    platforms.length * 20 +
+    SPAWN_POINTS.length * 8 +
+    4 * (wallGrid.cellStart.length + wallGrid.items.length + platformGrid.cellStart.length + platformGrid.items.length);
+
+  const out = new Uint8Array(size);
+  const view = new DataView(out.buffer);
+  let at = 0;
+  const u32 = (v: number) => {
+    view.setUint32(at, v, true);
+    at += 4;
+  };
+  const float = (v: number) => {
+    view.setFloat32(at, v, true);
+    at += 4;
+  };
+  u32(MAGIC);
+  u32(VERSION);
+  u32(size);
+  float(WORLD_HALF);
+  float(CELL_SIZE);
+  u32(walls.length);
+  u32(platforms.length);
+  u32(SPAWN_POINTS.length);
+  u32(wallGrid.items.length);
+  u32(platformGrid.items.length);
+  for (const box of walls) box.forEach(float);
+  for (const p of platforms) [p.minX, p.maxX, p.minZ, p.maxZ, p.h].forEach(float);
+  for (const [x, z] of SPAWN_POINTS) [x, z].forEach(float);
+  for (const grid of [wallGrid, platformGrid]) {
+    grid.cellStart.forEach(u32);
+    grid.items.forEach(u32);
+  }
+  return out;
+}
+
+const out = process.argv[2] ?? new URL("../../server/maps/city.bfmap", import.meta.url).pathname;
+// Renamed into place so a server that has the old file mapped keeps reading it intact.
+writeFileSync(`${out}.tmp`, encodeMap());
+renameSync(`${out}.tmp`, out);
+console.log(`wrote ${out}`);
@@ -20,6 +20,79 @@ export interface Snapshot {
   players: RemotePlayer[];
 }
 
+// Decoded snapshots kept as delta baselines; matches the server's history depth.
+const SNAPSHOT_HISTORY = 64;
+const SNAPSHOT_VERSION = 2;
+
+// Quantization ranges; must match server/addon/snapshot_codec.h.
+const MIN_Y = -8;
+const MAX_Y = 56;
+const MAX_VELOCITY = 32;
+const FIELD_COUNT = 13;
+
+// Per-entity change mask bits, in wire order.
+const F_X = 1 << 0;
+const F_Y = 1 << 1;
+const F_Z = 1 << 2;
+const F_VX = 1 << 3;
+const F_VY = 1 << 4;
+const F_VZ = 1 << 5;
+const F_YAW = 1 << 6;
+const F_PITCH = 1 << 7;
+const F_HEALTH = 1 << 8;
+const F_ACTIVE = 1 << 9;
+const F_IS_BOT = 1 << 10;
+const F_WEAPON = 1 << 11;
+const F_LAST_SEQ = 1 << 12;
+
+// LSB-first bit reader matching the server's BitWriter.
+class BitReader {
+  private pos = 0;
+
+  constructor(private bytes: Uint8Array) {}
+
+  read(bits: number): number {
+    let value = 0;
+    let shift = 0;
+    while (bits > 0) {
+      const byte = this.pos >>> 3;
+      if (byte >= this.bytes.length) throw new RangeError("snapshot truncated");
+      const offset = this.pos & 7;
+      const take = Math.min(bits, 8 - offset);
+      const chunk = (this.bytes[byte] >>> offset) & ((1 << take) - 1);
+      value += chunk * 2 ** shift;
+      shift += take;
+      bits -= take;
+      this.pos += take;
+    }
+    return value;
+  }
+
+  readBool(): boolean {
+    return this.read(1) === 1;
+  }
+
+  readVar(): number {
+    const bits = this.read(6);
+    return bits ? this.read(bits) : 0;
+  }
+}
+
+const floatScratch = new DataView(new ArrayBuffer(4));
+
+function bitsToFloat(bits: number) {
+  floatScratch.setUint32(0, bits, true);
+  return floatScratch.getFloat32(0, true);
+}
+
+function dequantizeLinear(q: number, lo: number, hi: number, bits: number) {
+  return lo + (hi - lo) * (q / (2 ** bits - 1));
+}
+
+function dequantizeAngle(q: number, lo: number, span: number, bits: number) {
+  return lo + (span * q) / 2 ** bits;
+}
+
 type SnapshotHandler = (snap: Snapshot) => void;
 
 type HandshakeHandler = (playerId: number) => void;
@@ -28,6 +101,8 @@ export class NetClient {
   private ws: WebSocket | null = null;
   private onSnapshot?: SnapshotHandler;
   private onHandshake?: HandshakeHandler;
+  private history: Array<Snapshot | null> = new Array(SNAPSHOT_HISTORY).fill(null);
+  private ackTick = 0;
 
   constructor(private url: string) {}
 
@@ -44,7 +119,7 @@ export class NetClient {
 
   sendInput(seq: number, moveX: number, moveZ: number, yaw: number, pitch: number, fire: boolean, weapon: number, jump: boolean) {
     if (!this.ws || this.ws.readyState !== WebSocket.OPEN) return;
-    const buf = new ArrayBuffer(23);
+    const buf = new ArrayBuffer(27);
     const view = new DataView(buf);
     let offset = 0;
     view.setUint32(offset, seq, true);
@@ -62,6 +137,8 @@ export class NetClient {
     view.setUint8(offset, weapon);
     offset += 1;
     view.setUint8(offset, jump ? 1 : 0);
+    offset += 1;
+    view.setUint32(offset, this.ackTick, true);
     this.ws.send(buf);
   }
 
@@ -87,47 +164,65 @@ export class NetClient {
   }
 
   private parseSnapshot(buf: ArrayBuffer): Snapshot | null {
-    const dv = new DataView(buf);
-    if (dv.byteLength < 6) return null;
-    let offset = 0;
-    const tick = dv.getUint32(offset, true);
-    offset += 4;
-    const count = dv.getUint16(offset, true);
-    offset += 2;
-    const players: RemotePlayer[] = [];
-    for (let i = 0; i < count; i++) {
-      if (offset + 4 + 4 * 8 + 2 + 1 + 1 + 1 + 4 > dv.byteLength) break;
-      const id = dv.getUint32(offset, true);
-      offset += 4;
-      const x = dv.getFloat32(offset, true);
-      offset += 4;
-      const y = dv.getFloat32(offset, true);
-      offset += 4;
-      const z = dv.getFloat32(offset, true);
-      offset += 4;
-      const vx = dv.getFloat32(offset, true);
-      offset += 4;
-      const vy = dv.getFloat32(offset, true);
-      offset += 4;
-      const vz = dv.getFloat32(offset, true);
-      offset += 4;
-      const yaw = dv.getFloat32(offset, true);
-      offset += 4;
-      const pitch = dv.getFloat32(offset, true);
-      offset += 4;
-      const health = dv.getInt16(offset, true);
-      offset += 2;
-      const active = dv.getUint8(offset) === 1;
-      offset += 1;
-      const isBot = dv.getUint8(offset) === 1;
-      offset += 1;
-      const weapon = dv.getUint8(offset);
-      offset += 1;
-      const lastSeq = dv.getUint32(offset, true);
-      offset += 4;
-      players.push({ id, x, y, z, vx, vy, vz, yaw, pitch, health, active, isBot, weapon, lastSeq });
-    }
+    const r = new BitReader(new Uint8Array(buf));
+    try {
+      const version = r.read(8);
+      if (version !== SNAPSHOT_VERSION) {
+        console.error("[net] unsupported snapshot version", version);
+        return null;
+      }
+      const tick = r.read(32);
+      const baseTick = r.read(32);
+      const posBits = r.read(5);
+      const velBits = r.read(5);
+      const yawBits = r.read(5);
+      const pitchBits = r.read(5);
+      const half = bitsToFloat(r.read(32));
+
+      const players = new Map<number, RemotePlayer>();
+      if (baseTick !== 0) {
+        const base = this.history[baseTick % SNAPSHOT_HISTORY];
+        // Baseline already evicted: drop it and keep acking our latest tick so the server resyncs us.
+        if (!base || base.tick !== baseTick) return null;
+        for (const p of base.players) players.set(p.id, p);
+      }
 
-    return { tick, players };
+      let id = 0;
+      while (r.readBool()) {
+        id += r.readVar();
+        players.delete(id);
+      }
+      id = 0;
+      while (r.readBool()) {
+        id += r.readVar();
+        const prev = players.get(id);
+        const p: RemotePlayer = prev
+          ? { ...prev }
+          : { id, x: 0, y: 0, z: 0, vx: 0, vy: 0, vz: 0, yaw: 0, pitch: 0, health: 0, active: false, isBot: false, weapon: 0, lastSeq: 0 };
+        const mask = r.read(FIELD_COUNT);
+        if (mask & F_X) p.x = dequantizeLinear(r.read(posBits), -half, half, posBits);
+        if (mask & F_Y) p.y = dequantizeLinear(r.read(posBits), MIN_Y, MAX_Y, posBits);
+        if (mask & F_Z) p.z = dequantizeLinear(r.read(posBits), -half, half, posBits);
+        if (mask & F_VX) p.vx = dequantizeLinear(r.read(velBits), -MAX_VELOCITY, MAX_VELOCITY, velBits);
+        if (mask & F_VY) p.vy = dequantizeLinear(r.read(velBits), -MAX_VELOCITY, MAX_VELOCITY, velBits);
+        if (mask & F_VZ) p.vz = dequantizeLinear(r.read(velBits), -MAX_VELOCITY, MAX_VELOCITY, velBits);
+        if (mask & F_YAW) p.yaw = dequantizeAngle(r.read(yawBits), -Math.PI, 2 * Math.PI, yawBits);
+        if (mask & F_PITCH) p.pitch = dequantizeLinear(r.read(pitchBits), -Math.PI / 2, Math.PI / 2, pitchBits);
+        if (mask & F_HEALTH) p.health = r.read(8);
+        if (mask & F_ACTIVE) p.active = r.readBool();
+        if (mask & F_IS_BOT) p.isBot = r.readBool();
+        if (mask & F_WEAPON) p.weapon = r.read(8);
+        if (mask & F_LAST_SEQ) p.lastSeq = r.readVar();
+        players.set(id, p);
+      }
+
+      const snap: Snapshot = { tick, players: Array.from(players.values()) };
+      this.history[tick % SNAPSHOT_HISTORY] = snap;
+      if (tick > this.ackTick) this.ackTick = tick;
+      return snap;
+    } catch (err) {
+      console.error("[net] truncated snapshot", err);
+      return null;
+    }
   }
 }
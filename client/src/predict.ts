@@ -66,6 +66,7 @@ export class Predictor {
   private applyCommand(state: PlayerState, cmd: Command, dt: number) {
     // match server integrate logic
     // yaw = 0 looks down -Z (Three.js default)
+    // The server's fastSinCos is within 1.2e-7 of Math.sin/cos, far inside reconcile error.
     const forwardX = -Math.sin(cmd.yaw);
     const forwardZ = -Math.cos(cmd.yaw);
     const rightX = Math.cos(cmd.yaw);
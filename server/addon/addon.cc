@@ -1,29 +1,227 @@
 #include <napi.h>
-#include "game_server.h"
+#include "replay.h"
+#include "room_pool.h"
+
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unordered_map>
 
 namespace {
-GameServer gServer;
-GameConfig gConfig{64, 40.0f, 0};
+// Every room, including the default one started by startServer, ticks on the
+// shared pool. The pool is created on first use so loading the addon spawns no threads.
+std::unique_ptr<RoomPool> gPool;
+RoomPool::Handle gDefaultRoom = RoomPool::kNoRoom;
+GameConfig gConfig{64, 40.0f, 0, {}};
+
+RoomPool &pool() {
+    if (!gPool) gPool = std::make_unique<RoomPool>();
+    return *gPool;
 }
 
-Napi::Value StartServer(const Napi::CallbackInfo &info) {
-    Napi::Env env = info.Env();
-    if (info.Length() > 0 && info[0].IsObject()) {
-        Napi::Object obj = info[0].As<Napi::Object>();
-        if (obj.Has("maxPlayers")) {
-            gConfig.maxPlayers = obj.Get("maxPlayers").As<Napi::Number>().Uint32Value();
+// The weak reference lets repeated polls of the same frame reuse one external
+// ArrayBuffer instead of wrapping the same memory twice.
+struct CachedSnapshot {
+    const SnapshotFrame *frame = nullptr;
+    uint32_t tick = 0;
+    Napi::Reference<Napi::ArrayBuffer> buffer;
+};
+
+// Keeps the room's frames alive for as long as JS holds a buffer over one.
+// bytes is what V8 was told the buffer keeps alive.
+struct PinnedFrame {
+    SnapshotFrame *frame;
+    std::shared_ptr<GameServer> room;
+    int64_t bytes;
+};
+
+uint64_t snapshotKey(RoomPool::Handle room, uint32_t clientId) {
+    return (static_cast<uint64_t>(room) << 32) | clientId;
+}
+
+// Per-env state, keyed by room and client id (0 is the full snapshot).
+// Each env runs on its own thread, so it pushes through its own input lane.
+struct AddonState {
+    std::unordered_map<uint64_t, CachedSnapshot> snapshots;
+    std::unordered_map<RoomPool::Handle, uint32_t> inputLanes;
+    ~AddonState();
+};
+
+AddonState &addonState(Napi::Env env) {
+    AddonState *state = env.GetInstanceData<AddonState>();
+    if (!state) {
+        state = new AddonState();
+        env.SetInstanceData(state);
+    }
+    return *state;
+}
+
+GameConfig parseConfig(const Napi::Value &value, GameConfig config) {
+    if (!value.IsObject()) return config;
+    Napi::Object obj = value.As<Napi::Object>();
+    if (obj.Has("maxPlayers")) {
+        config.maxPlayers = obj.Get("maxPlayers").As<Napi::Number>().Uint32Value();
+    }
+    if (obj.Has("worldHalfExtent")) {
+        config.worldHalfExtent = obj.Get("worldHalfExtent").As<Napi::Number>().FloatValue();
+    }
+    if (obj.Has("botCount")) {
+        config.botCount = obj.Get("botCount").As<Napi::Number>().Uint32Value();
+    }
+    if (obj.Has("inputBufferDepth")) {
+        config.inputBufferDepth = obj.Get("inputBufferDepth").As<Napi::Number>().Uint32Value();
+    }
+    if (obj.Has("seed")) {
+        config.seed = obj.Get("seed").As<Napi::Number>().Uint32Value();
+    }
+    if (obj.Has("recordPath") && obj.Get("recordPath").IsString()) {
+        config.recordPath = obj.Get("recordPath").As<Napi::String>().Utf8Value();
+    }
+    if (obj.Has("mapPath") && obj.Get("mapPath").IsString()) {
+        config.mapPath = obj.Get("mapPath").As<Napi::String>().Utf8Value();
+        // Checked here so a bad file fails the call, before any room exists,
+        // rather than falling back to the built-in map.
+        std::string error;
+        if (!MapFile::open(config.mapPath, &error)) throw Napi::Error::New(value.Env(), "Cannot load map: " + error);
+    }
+    if (obj.Has("maxRewindTicks")) {
+        config.maxRewindTicks = obj.Get("maxRewindTicks").As<Napi::Number>().Uint32Value();
+    }
+    if (obj.Has("interestRadius")) {
+        config.interestRadius = obj.Get("interestRadius").As<Napi::Number>().FloatValue();
+    }
+    if (obj.Has("interestMargin")) {
+        config.interestMargin = obj.Get("interestMargin").As<Napi::Number>().FloatValue();
+    }
+    if (obj.Has("inputRate")) {
+        config.inputRate.rate = obj.Get("inputRate").As<Napi::Number>().FloatValue();
+    }
+    if (obj.Has("inputBurst")) {
+        config.inputRate.burst = obj.Get("inputBurst").As<Napi::Number>().FloatValue();
+    }
+    if (obj.Has("snapshotBits") && obj.Get("snapshotBits").IsObject()) {
+        Napi::Object bits = obj.Get("snapshotBits").As<Napi::Object>();
+        SnapshotPrecision &prec = config.snapshotPrecision;
+        if (bits.Has("position")) prec.positionBits = static_cast<uint8_t>(bits.Get("position").As<Napi::Number>().Uint32Value());
+        if (bits.Has("velocity")) prec.velocityBits = static_cast<uint8_t>(bits.Get("velocity").As<Napi::Number>().Uint32Value());
+        if (bits.Has("yaw")) prec.yawBits = static_cast<uint8_t>(bits.Get("yaw").As<Napi::Number>().Uint32Value());
+        if (bits.Has("pitch")) prec.pitchBits = static_cast<uint8_t>(bits.Get("pitch").As<Napi::Number>().Uint32Value());
+    }
+    return config;
+}
+
+double parseTickRate(const Napi::Value &value) {
+    if (value.IsObject()) {
+        Napi::Object obj = value.As<Napi::Object>();
+        if (obj.Has("tickRate")) {
+            const double hz = obj.Get("tickRate").As<Napi::Number>().DoubleValue();
+            if (hz > 0.0) return hz;
         }
-        if (obj.Has("worldHalfExtent")) {
-            gConfig.worldHalfExtent = obj.Get("worldHalfExtent").As<Napi::Number>().FloatValue();
+    }
+    return 60.0;
+}
+
+// scheduler: { wait: "sleep" | "hybrid" | "timerfd", catchUp: "burst" |
+// "burstLimit" | "drop" | "slowMotion", burstLimit, spinUs }
+SchedulerConfig parseScheduler(const Napi::Value &value) {
+    SchedulerConfig config;
+    if (!value.IsObject()) return config;
+    Napi::Object options = value.As<Napi::Object>();
+    if (!options.Has("scheduler") || !options.Get("scheduler").IsObject()) return config;
+    Napi::Object obj = options.Get("scheduler").As<Napi::Object>();
+    if (obj.Has("wait")) {
+        const std::string wait = obj.Get("wait").As<Napi::String>().Utf8Value();
+        for (TickWait w : {TickWait::Sleep, TickWait::Hybrid, TickWait::TimerFd}) {
+            if (wait == tickWaitName(w)) config.wait = w;
         }
     }
-    gServer.start(gConfig);
+    if (obj.Has("catchUp")) {
+        const std::string catchUp = obj.Get("catchUp").As<Napi::String>().Utf8Value();
+        for (TickCatchUp c : {TickCatchUp::Burst, TickCatchUp::BurstLimit, TickCatchUp::Drop, TickCatchUp::SlowMotion}) {
+            if (catchUp == tickCatchUpName(c)) config.catchUp = c;
+        }
+    }
+    if (obj.Has("burstLimit")) config.burstLimit = obj.Get("burstLimit").As<Napi::Number>().Uint32Value();
+    if (obj.Has("spinUs")) config.spinWindow = std::chrono::microseconds(obj.Get("spinUs").As<Napi::Number>().Uint32Value());
+    return config;
+}
+
+// Room argument at index, or the default room when absent.
+RoomPool::Handle roomArg(const Napi::CallbackInfo &info, size_t index) {
+    if (info.Length() > index && info[index].IsNumber()) return info[index].As<Napi::Number>().Uint32Value();
+    return gDefaultRoom;
+}
+
+std::shared_ptr<GameServer> findRoom(RoomPool::Handle handle) {
+    if (handle == RoomPool::kNoRoom || !gPool) return nullptr;
+    return gPool->find(handle);
+}
+
+AddonState::~AddonState() {
+    for (const auto &[handle, lane] : inputLanes) {
+        if (std::shared_ptr<GameServer> room = findRoom(handle)) room->inputLanes().release(lane);
+    }
+}
+
+// Lane this env's thread pushes the room's input into, claimed on first use.
+uint32_t inputLane(Napi::Env env, RoomPool::Handle handle, GameServer &room) {
+    auto &lanes = addonState(env).inputLanes;
+    const auto it = lanes.find(handle);
+    if (it != lanes.end()) return it->second;
+    const uint32_t lane = room.inputLanes().claim();
+    if (lane != InputLanes::kNoLane) lanes.emplace(handle, lane);
+    return lane;
+}
+
+void forgetRoom(Napi::Env env, RoomPool::Handle handle) {
+    addonState(env).inputLanes.erase(handle);
+    auto &snapshots = addonState(env).snapshots;
+    for (auto it = snapshots.begin(); it != snapshots.end();) {
+        it = (it->first >> 32) == handle ? snapshots.erase(it) : std::next(it);
+    }
+}
+}
+
+Napi::Value StartServer(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (gDefaultRoom != RoomPool::kNoRoom) return env.Undefined();
+    const Napi::Value options = info.Length() > 0 ? info[0] : env.Undefined();
+    const GameConfig config = parseConfig(options, gConfig); // throws before anything changes
+    gDefaultRoom = pool().create(config, parseTickRate(options), parseScheduler(options));
+    gConfig = config;
     return env.Undefined();
 }
 
 Napi::Value StopServer(const Napi::CallbackInfo &info) {
-    gServer.stop();
-    return info.Env().Undefined();
+    Napi::Env env = info.Env();
+    if (gDefaultRoom == RoomPool::kNoRoom) return env.Undefined();
+    pool().destroy(gDefaultRoom);
+    forgetRoom(env, gDefaultRoom);
+    gDefaultRoom = RoomPool::kNoRoom;
+    return env.Undefined();
+}
+
+// createRoom(config?) returns a handle for the room-scoped calls below.
+Napi::Value CreateRoom(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    const Napi::Value options = info.Length() > 0 ? info[0] : env.Undefined();
+    const GameConfig config = parseConfig(options, GameConfig{64, 40.0f, 0, {}});
+    const RoomPool::Handle handle = pool().create(config, parseTickRate(options), parseScheduler(options));
+    return Napi::Number::New(env, handle);
+}
+
+Napi::Value DestroyRoom(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Expected room handle").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    const RoomPool::Handle handle = info[0].As<Napi::Number>().Uint32Value();
+    const bool destroyed = gPool && gPool->destroy(handle);
+    if (destroyed) forgetRoom(env, handle);
+    if (handle == gDefaultRoom) gDefaultRoom = RoomPool::kNoRoom;
+    return Napi::Boolean::New(env, destroyed);
 }
 
 Napi::Value PushInput(const Napi::CallbackInfo &info) {
@@ -49,58 +247,171 @@ Napi::Value PushInput(const Napi::CallbackInfo &info) {
 
     const uint8_t *data = static_cast<const uint8_t *>(buf.Data()) + offset;
     const size_t len = buf.ByteLength() - offset;
-    if (len < 23) {
+    InputPacket pkt;
+    if (!parseInputPacket(playerId, data, len, pkt)) {
         return Napi::Boolean::New(env, false);
     }
 
-    InputPacket pkt{};
-    size_t idx = 0;
-    auto read32 = [&]() {
-        uint32_t v;
-        std::memcpy(&v, data + idx, sizeof(v));
-        idx += sizeof(v);
-        return v;
-    };
-    auto readFloat = [&]() {
-        float v;
-        std::memcpy(&v, data + idx, sizeof(v));
-        idx += sizeof(v);
-        return v;
-    };
-
-    pkt.playerId = playerId;
-    pkt.seq = read32();
-    pkt.moveX = readFloat();
-    pkt.moveZ = readFloat();
-    pkt.yaw = readFloat();
-    pkt.pitch = readFloat();
-    pkt.fire = data[idx] != 0;
-    idx += 1;
-    pkt.weapon = data[idx];
-    idx += 1;
-    pkt.jump = idx < len ? (data[idx] != 0) : false;
-
-    bool ok = gServer.pushInput(pkt);
+    const RoomPool::Handle handle = roomArg(info, 2);
+    std::shared_ptr<GameServer> room = findRoom(handle);
+    if (!room) return Napi::Boolean::New(env, false);
+    bool ok = room->pushInput(pkt, inputLane(env, handle, *room));
     return Napi::Boolean::New(env, ok);
 }
 
+// getSnapshot(clientId?, room?) returns that client's delta, or the full snapshot.
 Napi::Value GetSnapshot(const Napi::CallbackInfo &info) {
     Napi::Env env = info.Env();
-    std::vector<uint8_t> snap;
-    gServer.getSnapshot(snap);
+    const RoomPool::Handle handle = roomArg(info, 1);
+    std::shared_ptr<GameServer> room = findRoom(handle);
+    if (!room) return Napi::ArrayBuffer::New(env, 0);
+    SnapshotView snap = room->getSnapshot();
     if (snap.empty()) {
         return Napi::ArrayBuffer::New(env, 0);
     }
-    Napi::ArrayBuffer buf = Napi::ArrayBuffer::New(env, snap.size());
-    std::memcpy(buf.Data(), snap.data(), snap.size());
+    const uint32_t clientId = info.Length() > 0 && info[0].IsNumber() ? info[0].As<Napi::Number>().Uint32Value() : 0;
+    const SnapshotSlice slice = snap.sliceFor(clientId);
+
+    AddonState &state = addonState(env);
+    CachedSnapshot &cached = state.snapshots[snapshotKey(handle, slice.clientId)];
+    if (cached.frame == snap.frame() && cached.tick == snap.tick() && !cached.buffer.IsEmpty()) {
+        Napi::ArrayBuffer buf = cached.buffer.Value();
+        // A live buffer still pins its frame, so the pointer cannot have been recycled.
+        if (!buf.IsEmpty()) return buf;
+    }
+
+    // Zero-copy: the ArrayBuffer borrows the frame and the finalizer returns it
+    // to the publisher's pool once V8 collects the buffer. JS must not write to it.
+    // Each buffer reports its own slice as external memory, so pinned frames
+    // push V8 to collect them; every client's buffer pins the same frame, so
+    // reporting the frame each time would count it once per client.
+    const uint32_t tick = snap.tick();
+    SnapshotFrame *frame = snap.detach();
+    const int64_t bytes = static_cast<int64_t>(slice.size);
+    Napi::MemoryManagement::AdjustExternalMemory(env, bytes);
+    Napi::ArrayBuffer buf = Napi::ArrayBuffer::New(
+        env, frame->data.data() + slice.offset, slice.size,
+        [](Napi::Env finalizeEnv, void *, PinnedFrame *pinned) {
+            Napi::MemoryManagement::AdjustExternalMemory(finalizeEnv, -pinned->bytes);
+            SnapshotPublisher::release(pinned->frame);
+            delete pinned;
+        },
+        new PinnedFrame{frame, std::move(room), bytes});
+    cached.frame = frame;
+    cached.tick = tick;
+    cached.buffer = Napi::Reference<Napi::ArrayBuffer>::New(buf, 0);
     return buf;
 }
 
+Napi::Value ForgetClient(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (info.Length() > 0 && info[0].IsNumber()) {
+        const RoomPool::Handle handle = roomArg(info, 1);
+        const uint32_t clientId = info[0].As<Napi::Number>().Uint32Value();
+        AddonState &state = addonState(env);
+        state.snapshots.erase(snapshotKey(handle, clientId));
+        const auto lane = state.inputLanes.find(handle);
+        std::shared_ptr<GameServer> room = findRoom(handle);
+        if (lane != state.inputLanes.end() && room) room->inputLanes().forget(lane->second, clientId);
+    }
+    return env.Undefined();
+}
+
+// replayInputLog(path) re-runs a recorded room synchronously, as fast as
+// possible, and reports whether every tick reproduced; null if unreadable
+// or recorded by a build that simulated differently (older log version).
+Napi::Value ReplayInputLog(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Expected log path").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    const ReplayResult r = replayInputLog(info[0].As<Napi::String>().Utf8Value());
+    if (!r.opened) return env.Null();
+    Napi::Object out = Napi::Object::New(env);
+    out.Set("ticks", Napi::Number::New(env, r.ticks));
+    out.Set("inputs", Napi::Number::New(env, static_cast<double>(r.inputs)));
+    out.Set("mismatches", Napi::Number::New(env, r.mismatches));
+    out.Set("firstMismatchTick", Napi::Number::New(env, r.firstMismatchTick));
+    out.Set("seconds", Napi::Number::New(env, r.seconds));
+    return out;
+}
+
+// getStats(room?) returns per-phase tick latency percentiles (ns) and counters
+// for the room, plus scheduling counters for the whole pool.
+Napi::Value GetStats(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    std::shared_ptr<GameServer> room = findRoom(roomArg(info, 0));
+    if (!room) return env.Null();
+    const TickProfiler &prof = room->profiler();
+    auto number = [&env](uint64_t v) { return Napi::Number::New(env, static_cast<double>(v)); };
+
+    auto histogram = [&number, &env](const LatencyHistogram &h) {
+        Napi::Object o = Napi::Object::New(env);
+        o.Set("count", number(h.count()));
+        o.Set("mean", number(h.count() ? h.sum() / h.count() : 0));
+        o.Set("p50", number(h.percentile(0.50)));
+        o.Set("p99", number(h.percentile(0.99)));
+        o.Set("p999", number(h.percentile(0.999)));
+        o.Set("max", number(h.max()));
+        return o;
+    };
+
+    Napi::Object phases = Napi::Object::New(env);
+    for (size_t i = 0; i < kTickPhaseCount; ++i) {
+        const TickPhase phase = static_cast<TickPhase>(i);
+        phases.Set(tickPhaseName(phase), histogram(prof.phase(phase)));
+    }
+
+    Napi::Object stats = Napi::Object::New(env);
+    stats.Set("ticks", number(prof.ticks()));
+    stats.Set("overruns", number(prof.overruns()));
+    stats.Set("inputsProcessed", number(prof.inputsProcessed()));
+    stats.Set("inputsDropped", number(prof.inputsDropped()));
+    stats.Set("snapshotBytes", number(prof.snapshotBytes()));
+    stats.Set("phases", phases);
+    stats.Set("startLag", histogram(prof.startLag()));
+    stats.Set("skippedTicks", number(prof.skippedTicks()));
+
+    const std::vector<PlayerInputStats> inputs = room->inputStats();
+    Napi::Array players = Napi::Array::New(env, inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const InputQueueStats &q = inputs[i].queue;
+        Napi::Object p = Napi::Object::New(env);
+        p.Set("id", number(inputs[i].playerId));
+        p.Set("buffered", number(q.buffered));
+        p.Set("underruns", number(q.underruns));
+        p.Set("overflows", number(q.overflows));
+        p.Set("duplicates", number(q.duplicates));
+        p.Set("late", number(q.late));
+        p.Set("rateLimited", number(inputs[i].drops.rateLimited));
+        p.Set("laneFull", number(inputs[i].drops.laneFull));
+        players.Set(static_cast<uint32_t>(i), p);
+    }
+    stats.Set("players", players);
+
+    const RoomPool::Stats poolStats = pool().stats();
+    Napi::Object poolObj = Napi::Object::New(env);
+    poolObj.Set("rooms", number(pool().roomCount()));
+    poolObj.Set("workers", number(pool().workerCount()));
+    poolObj.Set("ticks", number(poolStats.ticks));
+    poolObj.Set("lateTicks", number(poolStats.lateTicks));
+    poolObj.Set("maxLateNs", number(poolStats.maxLateNs));
+    poolObj.Set("skippedTicks", number(poolStats.skippedTicks));
+    stats.Set("pool", poolObj);
+    return stats;
+}
+
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
     exports.Set("startServer", Napi::Function::New(env, StartServer));
     exports.Set("stopServer", Napi::Function::New(env, StopServer));
     exports.Set("pushInput", Napi::Function::New(env, PushInput));
     exports.Set("getSnapshot", Napi::Function::New(env, GetSnapshot));
+    exports.Set("forgetClient", Napi::Function::New(env, ForgetClient));
+    exports.Set("createRoom", Napi::Function::New(env, CreateRoom));
+    exports.Set("destroyRoom", Napi::Function::New(env, DestroyRoom));
+    exports.Set("getStats", Napi::Function::New(env, GetStats));
+    exports.Set("replayInputLog", Napi::Function::New(env, ReplayInputLog));
     return exports;
 }
 
@@ -0,0 +1,109 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace bench {
+
+using BenchFn = void (*)();
+
+struct Registrar {
+    Registrar(const char *name, BenchFn fn);
+};
+
+inline uint64_t nowNs() {
+    using clock = std::chrono::steady_clock;
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count());
+}
+
+// Keeps the optimizer from discarding a computed value.
+template <typename T>
+inline void doNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T *sink;
+    sink = &value;
+#endif
+}
+
+// Marks the run failed: main exits non-zero once every selected case has run.
+void fail();
+
+// "match", or "MISMATCH" after marking the run failed.
+inline const char *verdict(bool ok) {
+    if (ok) return "match";
+    fail();
+    return "MISMATCH";
+}
+
+// Heap allocations made so far, counted by bench_main's operator new.
+uint64_t allocations();
+
+// One hot-path measurement, also written to the --json report.
+struct MicroResult {
+    const char *name;
+    uint32_t entities;
+    uint32_t walls; // colliders of the kind the op resolves against
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+// Prints the result and keeps it for the report.
+void report(const MicroResult &result);
+
+// Times op() in batches of calls that each perform opsPerCall operations.
+// reset() runs untimed before every batch to put the state back; the batch
+// size grows until one takes ~0.2 ms, then batches repeat for ~50 ms.
+template <typename Reset, typename Op>
+void micro(const char *name, uint32_t entities, uint32_t walls, uint32_t opsPerCall, Reset reset, Op op) {
+    uint32_t batch = 1;
+    for (;;) {
+        reset();
+        const uint64_t t0 = nowNs();
+        for (uint32_t i = 0; i < batch; ++i) op();
+        if (nowNs() - t0 >= 200000 || batch >= (1u << 20)) break;
+        batch *= 2;
+    }
+    uint64_t ns = 0, allocs = 0, calls = 0;
+    while (ns < 50000000) {
+        reset();
+        const uint64_t a0 = allocations();
+        const uint64_t t0 = nowNs();
+        for (uint32_t i = 0; i < batch; ++i) op();
+        ns += nowNs() - t0;
+        allocs += allocations() - a0;
+        calls += batch;
+    }
+    const double ops = static_cast<double>(calls) * opsPerCall;
+    report({name, entities, walls, static_cast<double>(ns) / ops, static_cast<double>(allocs) / ops});
+}
+
+inline uint64_t percentile(const std::vector<uint64_t> &sorted, double p) {
+    if (sorted.empty()) return 0;
+    const size_t idx = std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())));
+    return sorted[idx];
+}
+
+inline void printLatency(const char *label, std::vector<uint64_t> &samplesNs) {
+    std::sort(samplesNs.begin(), samplesNs.end());
+    std::printf("  %-28s n=%-8zu p50=%-8llu p99=%-8llu p999=%-8llu max=%llu (ns)\n", label, samplesNs.size(),
+                static_cast<unsigned long long>(percentile(samplesNs, 0.50)),
+                static_cast<unsigned long long>(percentile(samplesNs, 0.99)),
+                static_cast<unsigned long long>(percentile(samplesNs, 0.999)),
+                static_cast<unsigned long long>(samplesNs.empty() ? 0 : samplesNs.back()));
+}
+
+} // namespace bench
+
+#define BENCH_CASE(name)                                             \
+    static void name();                                              \
+    static const bench::Registrar name##_registrar(#name, name);     \
+    static void name()
+
+#endif
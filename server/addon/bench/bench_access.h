@@ -0,0 +1,247 @@
+#ifndef BENCH_ACCESS_H
+#define BENCH_ACCESS_H
+
+#include "bench.h"
+#include "../game_server.h"
+#include "../weapon_defs.h"
+
+#include <algorithm>
+#include <memory>
+
+constexpr float kBenchDt = 1.0f / 60.0f;
+
+// Uniform in [0, 1) from an LCG, so bench worlds are the same every run.
+inline float benchRandom(uint32_t &state) {
+    state = state * 1664525u + 1013904223u;
+    return static_cast<float>(state >> 8) / static_cast<float>(1u << 24);
+}
+
+// Friend of GameServer: lets benches set up state and drive single phases.
+struct BenchAccess {
+    static PlayerStore &players(GameServer &server) { return server.players_; }
+    static uint32_t slotOf(const GameServer &server, uint32_t id) { return server.findPlayer(id); }
+    static uint32_t tick(const GameServer &server) { return server.tickCount_.load(); }
+
+    // Standing still on the floor at (x, z).
+    static void place(GameServer &server, uint32_t slot, float x, float z) {
+        PlayerStore &p = server.players_;
+        p.x[slot] = x;
+        p.y[slot] = 1.2f;
+        p.z[slot] = z;
+        p.vx[slot] = p.vy[slot] = p.vz[slot] = 0.0f;
+        server.grid_.update(slot, x, z);
+    }
+
+    // One shotgun shot from slot, off cooldown, by a client that has decoded
+    // the snapshot for ackTick.
+    static void fire(GameServer &server, uint32_t slot, uint32_t ackTick, float yaw, float pitch) {
+        PlayerInfo &info = server.players_.info[slot];
+        info.ackTick = ackTick;
+        info.lastFireTick = server.tickCount_.load() - kShotgun.cooldownTicks;
+        InputPacket in{};
+        in.playerId = info.id;
+        in.seq = info.lastSeq + 1;
+        in.yaw = yaw;
+        in.pitch = pitch;
+        in.fire = true;
+        server.applyInput(slot, in, kBenchDt);
+    }
+
+    static void setMaxRewind(GameServer &server, uint32_t ticks) { server.config_.maxRewindTicks = ticks; }
+
+    // The per-tick history write, as stepSimulation does it (at tick + 1).
+    static void recordPositions(GameServer &server) {
+        const PlayerStore &p = server.players_;
+        server.positions_.record(server.tickCount_.load() + 1, static_cast<uint32_t>(p.size()), p.x.data(),
+                                 p.y.data(), p.z.data());
+    }
+
+    // Lets populate()d players be rewound: starts their history now.
+    static void startHistory(GameServer &server) {
+        for (uint32_t i = 0; i < server.players_.size(); ++i) server.positions_.restart(i, server.tickCount_.load() + 1);
+    }
+
+    static SpiderStore &spiders(GameServer &server) { return server.spiders_; }
+    static void nextTick(GameServer &server) { server.tickCount_.fetch_add(1); }
+
+    // Every client has decoded the snapshot for ackTick.
+    static void ackAll(GameServer &server, uint32_t ackTick) {
+        for (PlayerInfo &info : server.players_.info) info.ackTick = ackTick;
+    }
+
+    // Single hot paths, as the tick calls them.
+    static void integratePlayer(GameServer &server, uint32_t slot, const InputPacket &in) {
+        server.integratePlayer(slot, in, kBenchDt);
+    }
+    // After moving every player by its velocity.
+    static void resolveWalls(GameServer &server) {
+        PlayerStore &p = server.players_;
+        const uint32_t n = static_cast<uint32_t>(p.size());
+        server.moveFromX_.resize(n);
+        server.moveFromZ_.resize(n);
+        for (uint32_t i = 0; i < n; ++i) {
+            server.moveFromX_[i] = p.x[i] - p.vx[i] * kBenchDt;
+            server.moveFromZ_[i] = p.z[i] - p.vz[i] * kBenchDt;
+        }
+        server.resolveWalls(0, n, p.active.data(), server.moveFromX_.data(), server.moveFromZ_.data());
+    }
+    // After moving every player from (fromX, fromZ).
+    static void resolveWalls(GameServer &server, const std::vector<float> &fromX, const std::vector<float> &fromZ) {
+        PlayerStore &p = server.players_;
+        server.resolveWalls(0, static_cast<uint32_t>(p.size()), p.active.data(), fromX.data(), fromZ.data());
+    }
+    // Moves at least this much longer than the player radius are swept;
+    // buildColliders() puts back half the thinnest wall.
+    static void setSweepFrom(GameServer &server, float halfWidth) { server.minWallHalfWidth_ = halfWidth; }
+    static void resolvePlatforms(GameServer &server) {
+        server.resolvePlatforms(0, static_cast<uint32_t>(server.players_.size()), server.players_.active.data(),
+                                kBenchDt);
+    }
+    static void resolveSpiderWalls(GameServer &server) {
+        for (uint32_t s = 0; s < server.spiders_.size(); ++s) {
+            server.resolveSpiderWalls(s, server.spiders_.x[s], server.spiders_.z[s]);
+        }
+    }
+    static bool blockedByWall(const GameServer &server, float x, float z) { return server.blockedByWall(x, z); }
+    static float staticRayDistance(const GameServer &server, float ox, float oy, float oz, float dx, float dy, float dz,
+                                   float maxDist) {
+        return server.staticRayDistance(ox, oy, oz, dx, dy, dz, maxDist);
+    }
+
+    static std::vector<Wall> &walls(GameServer &server) { return server.walls_; }
+    static std::vector<Platform> &platforms(GameServer &server) { return server.platforms_; }
+    static void buildColliders(GameServer &server) { server.buildColliders(); }
+    // setupMap from a map file, as a room start does.
+    static void loadMap(GameServer &server, const std::string &path) {
+        server.config_.mapPath = path;
+        server.setupMap();
+    }
+    // The same geometry set up without a file: copied in and grids built here.
+    static void loadGeometry(GameServer &server, const MapGeometry &map) {
+        server.config_.worldHalfExtent = map.worldHalfExtent;
+        server.walls_ = map.walls;
+        server.platforms_ = map.platforms;
+        server.spawns_ = map.spawns;
+        server.buildColliders();
+    }
+    // Grids on whatever the collider count, or off so every collider is looped over.
+    static void setColliderGrids(GameServer &server, bool on) {
+        if (on) {
+            server.wallGrid_.build(server.walls_, server.config_.worldHalfExtent, 4.0f);
+            server.platformGrid_.build(server.platforms_, server.config_.worldHalfExtent, 4.0f);
+        } else {
+            server.wallGrid_.clear();
+            server.platformGrid_.clear();
+        }
+    }
+    static void updateBots(GameServer &server) { server.updateBots(kBenchDt); }
+    static void updateSpiders(GameServer &server) { server.updateSpiders(kBenchDt); }
+    static void buildSnapshot(GameServer &server) { server.buildSnapshot(); }
+
+    // The perimeter walls plus scattered 1 x 4 m interior walls, count in all.
+    static void setWalls(GameServer &server, uint32_t count) {
+        uint32_t state = 5;
+        server.walls_.resize(std::min<size_t>(server.walls_.size(), 4));
+        while (server.walls_.size() < count) {
+            const float x = benchRandom(state) * 76.0f - 38.0f;
+            const float z = benchRandom(state) * 76.0f - 38.0f;
+            const bool alongX = server.walls_.size() % 2 == 0;
+            server.walls_.push_back({x, x + (alongX ? 4.0f : 1.0f), z, z + (alongX ? 1.0f : 4.0f)});
+        }
+        server.buildColliders();
+    }
+
+    // count 3 x 3 m platforms at heights a jump reaches.
+    static void setPlatforms(GameServer &server, uint32_t count) {
+        uint32_t state = 11;
+        server.platforms_.clear();
+        for (uint32_t i = 0; i < count; ++i) {
+            const float x = benchRandom(state) * 76.0f - 38.0f;
+            const float z = benchRandom(state) * 76.0f - 38.0f;
+            server.platforms_.push_back({x, x + 3.0f, z, z + 3.0f, 1.2f + benchRandom(state) * 2.0f});
+        }
+        server.buildColliders();
+    }
+
+    // n spiders scattered over the map.
+    static void spawnSpiders(GameServer &server, uint32_t n) {
+        uint32_t state = 3;
+        for (uint32_t i = 0; i < n; ++i) {
+            const float x = benchRandom(state) * 80.0f - 40.0f;
+            const float z = benchRandom(state) * 80.0f - 40.0f;
+            server.spawnSpider(x, z);
+        }
+    }
+
+    // n players scattered over the whole map (so some overlap the border
+    // walls) with random velocities, some airborne; bots join on the first
+    // updateBots.
+    static void populate(GameServer &server, uint32_t n, uint32_t bots = 0) {
+        GameConfig config{n + bots, 40.0f, bots, {}};
+        server.startHeadless(config);
+        uint32_t state = 99;
+        auto rnd = [&state]() { return benchRandom(state); };
+        PlayerStore &players = server.players_;
+        for (uint32_t i = 0; i < n; ++i) {
+            const uint32_t slot = players.add(i + 1, false);
+            players.active[slot] = 1;
+            players.health[slot] = 100;
+            players.x[slot] = rnd() * 80.0f - 40.0f;
+            players.z[slot] = rnd() * 80.0f - 40.0f;
+            players.y[slot] = 1.2f + rnd() * 3.0f;
+            players.vx[slot] = rnd() * 24.0f - 12.0f;
+            players.vz[slot] = rnd() * 24.0f - 12.0f;
+            players.vy[slot] = rnd() * 10.0f - 5.0f;
+            server.grid_.update(slot, players.x[slot], players.z[slot]);
+        }
+        server.idle_.assign(n, 1);
+    }
+
+    static void perPlayer(GameServer &server) {
+        PlayerStore &players = server.players_;
+        for (uint32_t i = 0; i < players.size(); ++i) {
+            InputPacket idle{};
+            idle.yaw = players.yaw[i];
+            idle.pitch = players.pitch[i];
+            server.integratePlayer(i, idle, kBenchDt);
+        }
+    }
+
+    static bool same(const PlayerStore &a, const PlayerStore &b) {
+        return a.x == b.x && a.y == b.y && a.z == b.z && a.vx == b.vx && a.vy == b.vy && a.vz == b.vz &&
+               a.grounded == b.grounded;
+    }
+
+    // Times the per-player and batched idle movement passes over n players.
+    static void runMovement(uint32_t n) {
+        auto server = std::make_unique<GameServer>();
+        populate(*server, n);
+        const PlayerStore saved = server->players_;
+
+        perPlayer(*server);
+        const PlayerStore expected = server->players_;
+        server->players_ = saved;
+        server->integrateIdle(kBenchDt);
+        const bool match = same(expected, server->players_);
+
+        const int iters = static_cast<int>(200000 / n + 50);
+        uint64_t scalarNs = 0, batchNs = 0;
+        for (int it = 0; it < iters; ++it) {
+            server->players_ = saved;
+            uint64_t t0 = bench::nowNs();
+            perPlayer(*server);
+            scalarNs += bench::nowNs() - t0;
+            server->players_ = saved;
+            t0 = bench::nowNs();
+            server->integrateIdle(kBenchDt);
+            batchNs += bench::nowNs() - t0;
+            bench::doNotOptimize(server->players_.x[0]);
+        }
+        std::printf("  n=%-5u per-player %9.1f ns (%5.2f ns/player)  batched %9.1f ns (%5.2f ns/player)  %s\n", n,
+                    static_cast<double>(scalarNs) / iters, static_cast<double>(scalarNs) / iters / n,
+                    static_cast<double>(batchNs) / iters, static_cast<double>(batchNs) / iters / n,
+                    match ? "match" : "MISMATCH");
+    }
+};
+
+#endif
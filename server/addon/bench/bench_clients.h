@@ -0,0 +1,33 @@
+#ifndef BENCH_CLIENTS_H
+#define BENCH_CLIENTS_H
+
+#include "../game_server.h"
+
+#include <cmath>
+
+namespace bench {
+
+// Strafing, turning clients that fire about twice a second. Every client skips
+// one tick in eight so the idle integration path runs too. Clients ack 6 ticks
+// back, or acks[c] when given.
+inline void pushClientInputs(GameServer &server, uint32_t clients, uint32_t tick, const uint32_t *acks = nullptr) {
+    for (uint32_t c = 0; c < clients; ++c) {
+        if ((tick + c) % 8 == 0) continue;
+        const float t = static_cast<float>(tick) + static_cast<float>(c) * 7.0f;
+        InputPacket in{};
+        in.playerId = c + 1;
+        in.seq = tick;
+        in.moveX = std::sin(t * 0.05f);
+        in.moveZ = 1.0f;
+        in.yaw = static_cast<float>(c) + t * 0.02f;
+        in.pitch = 0.1f * std::sin(t * 0.03f);
+        in.fire = (tick + c) % 30 == 0;
+        in.jump = (tick + c) % 90 == 0;
+        in.ackTick = acks ? acks[c] : tick > 6 ? tick - 6 : 0;
+        server.pushInput(in);
+    }
+}
+
+} // namespace bench
+
+#endif
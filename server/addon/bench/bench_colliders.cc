@@ -0,0 +1,112 @@
+#include "bench.h"
+#include "bench_access.h"
+
+#include <memory>
+
+namespace {
+constexpr uint32_t kPlayers = 512;
+constexpr uint32_t kSpiders = 512;
+constexpr uint32_t kSpawnTests = 4096;
+
+// Walls of a city block: thin walls, building footprints and small props
+// (lamps, benches, trees), scattered over the map on top of the perimeter.
+void scatterColliders(GameServer &server, uint32_t count) {
+    std::vector<Wall> &walls = BenchAccess::walls(server);
+    std::vector<Platform> &platforms = BenchAccess::platforms(server);
+    walls.resize(4);
+    platforms.clear();
+    uint32_t state = 77;
+    for (uint32_t i = 0; i < count; ++i) {
+        const float x = benchRandom(state) * 78.0f - 39.0f;
+        const float z = benchRandom(state) * 78.0f - 39.0f;
+        float w, d;
+        switch (i % 4) {
+            case 0: w = 0.3f; d = 2.0f + benchRandom(state) * 4.0f; break;  // wall
+            case 1: w = d = 3.0f + benchRandom(state) * 5.0f; break;        // building
+            default: w = d = 0.3f + benchRandom(state) * 0.7f; break;       // prop
+        }
+        walls.push_back({x, x + w, z, z + d});
+        const float side = 1.0f + benchRandom(state) * 2.0f;
+        platforms.push_back({x, x + side, z, z + side, 1.2f + benchRandom(state) * 2.0f});
+    }
+    BenchAccess::buildColliders(server);
+}
+
+// ns per call of op, after reset() (untimed) before each call.
+template <typename Reset, typename Op>
+double timePerCall(int reps, Reset reset, Op op) {
+    uint64_t ns = 0;
+    for (int r = 0; r < reps; ++r) {
+        reset();
+        const uint64_t t0 = bench::nowNs();
+        op();
+        ns += bench::nowNs() - t0;
+    }
+    return static_cast<double>(ns) / reps;
+}
+
+struct PassTimes {
+    double walls, platforms, spiders, spawn; // ns per entity or test
+    PlayerStore afterWalls, afterPlatforms;
+    SpiderStore afterSpiders;
+    uint32_t blocked = 0;
+};
+
+PassTimes runPasses(GameServer &server, const PlayerStore &players, const SpiderStore &spiders, int reps) {
+    PassTimes t;
+    PlayerStore &live = BenchAccess::players(server);
+    SpiderStore &liveSpiders = BenchAccess::spiders(server);
+    t.walls = timePerCall(reps, [&] { live = players; }, [&] { BenchAccess::resolveWalls(server); }) / kPlayers;
+    t.afterWalls = live;
+    t.platforms =
+        timePerCall(reps, [&] { live = players; }, [&] { BenchAccess::resolvePlatforms(server); }) / kPlayers;
+    t.afterPlatforms = live;
+    t.spiders =
+        timePerCall(reps, [&] { liveSpiders = spiders; }, [&] { BenchAccess::resolveSpiderWalls(server); }) / kSpiders;
+    t.afterSpiders = liveSpiders;
+    t.spawn = timePerCall(reps, [] {}, [&] {
+        uint32_t state = 13;
+        t.blocked = 0;
+        for (uint32_t i = 0; i < kSpawnTests; ++i) {
+            const float x = benchRandom(state) * 80.0f - 40.0f;
+            const float z = benchRandom(state) * 80.0f - 40.0f;
+            t.blocked += BenchAccess::blockedByWall(server, x, z);
+        }
+    }) / kSpawnTests;
+    return t;
+}
+
+void runColliders(uint32_t count) {
+    auto server = std::make_unique<GameServer>();
+    BenchAccess::populate(*server, kPlayers);
+    BenchAccess::spawnSpiders(*server, kSpiders);
+    scatterColliders(*server, count);
+    const PlayerStore players = BenchAccess::players(*server);
+    const SpiderStore spiders = BenchAccess::spiders(*server);
+    const int reps = count >= 5000 ? 5 : 40;
+
+    const double buildUs = timePerCall(reps, [] {}, [&] { BenchAccess::setColliderGrids(*server, true); }) / 1e3;
+    const PassTimes grid = runPasses(*server, players, spiders, reps);
+    BenchAccess::setColliderGrids(*server, false);
+    const PassTimes loop = runPasses(*server, players, spiders, reps);
+
+    const bool match = BenchAccess::same(loop.afterWalls, grid.afterWalls) &&
+                       BenchAccess::same(loop.afterPlatforms, grid.afterPlatforms) &&
+                       loop.afterSpiders.x == grid.afterSpiders.x && loop.afterSpiders.z == grid.afterSpiders.z &&
+                       loop.blocked == grid.blocked;
+    std::printf("  %u walls + %u platforms, grid build %.1f us (both)  %s\n", count + 4, count, buildUs,
+                bench::verdict(match));
+    std::printf("    players vs walls     loop %9.1f  grid %7.1f ns/player\n", loop.walls, grid.walls);
+    std::printf("    players vs platforms loop %9.1f  grid %7.1f ns/player\n", loop.platforms, grid.platforms);
+    std::printf("    spiders vs walls     loop %9.1f  grid %7.1f ns/spider\n", loop.spiders, grid.spiders);
+    std::printf("    spawn point test     loop %9.1f  grid %7.1f ns/test\n", loop.spawn, grid.spawn);
+}
+} // namespace
+
+// Static collision with every collider looped over vs the collider grid, on
+// 512 players and 512 spiders; both must leave identical state.
+BENCH_CASE(collider_grid) {
+    runColliders(10);
+    runColliders(500);
+    runColliders(5000);
+}
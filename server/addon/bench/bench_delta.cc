@@ -0,0 +1,199 @@
+#include "bench.h"
+#include "../snapshot_codec.h"
+
+#include <cmath>
+
+namespace {
+constexpr uint32_t kPlayers = 64;
+constexpr uint32_t kTicks = 600;
+constexpr uint32_t kAckLagTicks = 6; // ~100 ms round trip at 60 Hz
+constexpr float kHalfExtent = 50.0f;
+// Unquantized v1 layout: 12-byte header, 57 bytes per entity (id, mask, 51 bytes of fields).
+constexpr size_t kFloatHeaderBytes = 12;
+constexpr size_t kFloatEntityBytes = 57;
+
+struct Lcg {
+    uint32_t state = 12345;
+    float next() {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8) / static_cast<float>(1u << 24);
+    }
+};
+
+struct SimPlayer {
+    uint32_t id;
+    float x, y, z, vx, vy, vz, yaw, pitch;
+    int32_t health;
+    uint32_t lastSeq;
+};
+
+EntitySnapshot quantize(const SnapshotQuantizer &q, const SimPlayer &p) {
+    EntitySnapshot e{};
+    e.id = p.id;
+    e.x = q.position(p.x);
+    e.y = q.height(p.y);
+    e.z = q.position(p.z);
+    e.vx = q.velocity(p.vx);
+    e.vy = q.velocity(p.vy);
+    e.vz = q.velocity(p.vz);
+    e.yaw = q.yaw(p.yaw);
+    e.pitch = q.pitch(p.pitch);
+    e.health = static_cast<uint8_t>(p.health);
+    e.active = 1;
+    e.lastSeq = p.lastSeq;
+    return e;
+}
+
+std::vector<SimPlayer> makeWorld(Lcg &rng) {
+    std::vector<SimPlayer> world(kPlayers);
+    for (uint32_t i = 0; i < kPlayers; ++i) {
+        SimPlayer &p = world[i];
+        p = SimPlayer{};
+        p.id = i + 1;
+        p.x = rng.next() * 80.0f - 40.0f;
+        p.y = 1.2f;
+        p.z = rng.next() * 80.0f - 40.0f;
+        p.yaw = rng.next() * 6.0f - 3.0f;
+        p.health = 100;
+    }
+    return world;
+}
+
+enum class Activity { Idle, Looking, Moving };
+
+// moving/looking: share of players in that activity; each player keeps its
+// activity for about two seconds before re-rolling it.
+void runScenario(const char *label, float moving, float looking) {
+    Lcg rng;
+    const SnapshotQuantizer quantizer(SnapshotPrecision{}, kHalfExtent);
+    std::vector<SimPlayer> world = makeWorld(rng);
+    std::vector<Activity> activity(kPlayers, Activity::Idle);
+
+    SnapshotHistory history;
+    std::vector<uint8_t> out;
+    uint64_t fullBytes = 0;
+    uint64_t deltaBytes = 0;
+    for (uint32_t tick = 1; tick <= kTicks; ++tick) {
+        for (uint32_t i = 0; i < kPlayers; ++i) {
+            SimPlayer &p = world[i];
+            if (tick == 1 || rng.next() < 1.0f / 120.0f) {
+                const float roll = rng.next();
+                activity[i] = roll < moving ? Activity::Moving : roll < moving + looking ? Activity::Looking : Activity::Idle;
+            }
+            if (activity[i] == Activity::Moving) {
+                p.vx = rng.next() * 24.0f - 12.0f;
+                p.vz = rng.next() * 24.0f - 12.0f;
+                p.x += p.vx / 60.0f;
+                p.z += p.vz / 60.0f;
+                p.yaw += rng.next() * 0.2f - 0.1f;
+            } else if (activity[i] == Activity::Looking) {
+                p.yaw += rng.next() * 0.2f - 0.1f;
+                p.pitch = std::sin(static_cast<float>(tick) * 0.05f);
+            } else {
+                p.vx = p.vz = 0.0f;
+            }
+            p.lastSeq = tick;
+        }
+        std::vector<EntitySnapshot> &current = history.begin(tick);
+        for (const auto &p : world) current.push_back(quantize(quantizer, p));
+
+        // Old scheme: the same unquantized full blob to everyone.
+        fullBytes += (kFloatHeaderBytes + kFloatEntityBytes * kPlayers) * kPlayers;
+
+        const uint32_t ack = tick > kAckLagTicks ? tick - kAckLagTicks : 0;
+        const std::vector<EntitySnapshot> *base = ack ? history.find(ack) : nullptr;
+        for (const auto &viewer : world) {
+            out.clear();
+            encodeSnapshot(tick, ack, quantizer, base, current, viewer.id, out);
+            deltaBytes += out.size();
+        }
+    }
+    const double fullPerTick = static_cast<double>(fullBytes) / kTicks;
+    const double deltaPerTick = static_cast<double>(deltaBytes) / kTicks;
+    std::printf("  %-10s full=%9.0f B/tick  delta=%9.0f B/tick  ratio=%5.1fx  (%.1f KiB/s per client)\n", label,
+                fullPerTick, deltaPerTick, fullPerTick / deltaPerTick, deltaPerTick / kPlayers * 60.0 / 1024.0);
+}
+} // namespace
+
+BENCH_CASE(snapshot_delta_bytes) {
+    std::printf(" %u players, %u ticks, acks lag %u ticks, vs unquantized full broadcast\n", kPlayers, kTicks,
+                kAckLagTicks);
+    runScenario("idle", 0.0f, 0.0f);
+    runScenario("typical", 0.25f, 0.25f);
+    runScenario("busy", 1.0f, 0.0f);
+
+    // Encode cost for one tick's worth of per-client deltas.
+    const SnapshotQuantizer quantizer(SnapshotPrecision{}, kHalfExtent);
+    std::vector<EntitySnapshot> base(kPlayers), current(kPlayers);
+    for (uint32_t i = 0; i < kPlayers; ++i) {
+        base[i] = EntitySnapshot{};
+        base[i].id = i + 1;
+        current[i] = base[i];
+        if (i % 2 == 0) current[i].x += 7;
+    }
+    std::vector<uint8_t> out;
+    out.reserve(1 << 16);
+    const int iters = 2000;
+    const uint64_t t0 = bench::nowNs();
+    for (int it = 0; it < iters; ++it) {
+        out.clear();
+        for (uint32_t v = 1; v <= kPlayers; ++v) encodeSnapshot(2, 1, quantizer, &base, current, v, out);
+        bench::doNotOptimize(out.data());
+    }
+    std::printf("  encode %u client deltas: %.1f us/tick\n", kPlayers,
+                static_cast<double>(bench::nowNs() - t0) / iters / 1000.0);
+}
+
+// Full-snapshot size and worst-case reconstruction error at several precisions.
+BENCH_CASE(snapshot_quantization) {
+    struct Setting {
+        const char *label;
+        SnapshotPrecision precision;
+    };
+    const Setting settings[] = {
+        {"pos14/vel10/ang12", {14, 10, 12, 12}},
+        {"default", SnapshotPrecision{}},
+        {"pos18/vel14/ang16", {18, 14, 16, 16}},
+    };
+    const size_t floatBytes = kFloatHeaderBytes + kFloatEntityBytes * kPlayers;
+    for (const auto &setting : settings) {
+        Lcg rng;
+        const SnapshotQuantizer quantizer(setting.precision, kHalfExtent);
+        std::vector<SimPlayer> world = makeWorld(rng);
+        for (auto &p : world) {
+            p.y = 1.2f + rng.next() * 3.0f;
+            p.vx = rng.next() * 24.0f - 12.0f;
+            p.vy = rng.next() * 22.0f - 11.0f;
+            p.vz = rng.next() * 24.0f - 12.0f;
+            p.pitch = rng.next() * 2.8f - 1.4f;
+            p.lastSeq = 100000 + p.id;
+        }
+        SnapshotHistory history;
+        std::vector<EntitySnapshot> &current = history.begin(1);
+        for (const auto &p : world) current.push_back(quantize(quantizer, p));
+        std::vector<uint8_t> out;
+        encodeSnapshot(1, 0, quantizer, nullptr, current, 0, out);
+
+        SnapshotHeader header{};
+        std::vector<EntitySnapshot> decoded;
+        SnapshotHistory clientHistory;
+        const bool ok = decodeSnapshot(out.data(), out.size(), clientHistory, header, decoded);
+        float posErr = 0.0f, velErr = 0.0f, angErr = 0.0f;
+        for (size_t i = 0; ok && i < decoded.size(); ++i) {
+            const SimPlayer &p = world[i];
+            const EntitySnapshot &e = decoded[i];
+            const SnapshotQuantizer &q = header.quantizer;
+            posErr = std::max({posErr, std::fabs(q.positionValue(e.x) - p.x), std::fabs(q.heightValue(e.y) - p.y),
+                               std::fabs(q.positionValue(e.z) - p.z)});
+            velErr = std::max({velErr, std::fabs(q.velocityValue(e.vx) - p.vx),
+                               std::fabs(q.velocityValue(e.vy) - p.vy), std::fabs(q.velocityValue(e.vz) - p.vz)});
+            float dyaw = std::fabs(q.yawValue(e.yaw) - p.yaw);
+            dyaw = std::min(dyaw, 6.2831853f - dyaw);
+            angErr = std::max({angErr, dyaw, std::fabs(q.pitchValue(e.pitch) - p.pitch)});
+        }
+        std::printf("  %-18s %4zu B (float %zu B, %.0f%%)  max err pos=%.4f vel=%.4f ang=%.5f rad%s\n",
+                    setting.label, out.size(), floatBytes, 100.0 * out.size() / floatBytes, posErr, velErr, angErr,
+                    ok ? "" : "  DECODE FAILED");
+        if (!ok) bench::fail();
+    }
+}
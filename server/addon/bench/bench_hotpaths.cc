@@ -0,0 +1,188 @@
+#include "bench.h"
+#include "bench_access.h"
+#include "../pellet_kernel.h"
+
+#include <cmath>
+#include <memory>
+
+// Simulation hot paths by entity and wall count, in ns and heap allocations
+// per op; `bench --json PATH hotpath_` writes them for diffing between releases.
+// An op is one call of the function named, except integrate_player (one
+// player) and ray_sphere (one ray against one sphere). walls is 0 where no
+// colliders are involved.
+
+namespace {
+constexpr uint32_t kHumans = 64; // targets for bots and spiders
+constexpr float kHitRadius = 0.6f;
+
+std::unique_ptr<GameServer> crowd(uint32_t n, uint32_t walls, uint32_t bots = 0) {
+    auto server = std::make_unique<GameServer>();
+    BenchAccess::populate(*server, n, bots);
+    BenchAccess::setWalls(*server, walls);
+    PlayerStore &players = BenchAccess::players(*server);
+    for (uint32_t i = 0; i < n; ++i) players.health[i] = 1 << 30; // nobody dies
+    return server;
+}
+
+SphereTargets spheres(uint32_t n) {
+    SphereTargets targets;
+    uint32_t state = 17;
+    for (uint32_t i = 0; i < n; ++i) {
+        targets.push(i, benchRandom(state) * 30.0f - 15.0f, 1.2f + benchRandom(state) * 2.0f,
+                     -benchRandom(state) * 22.0f);
+    }
+    return targets;
+}
+} // namespace
+
+BENCH_CASE(hotpath_integrate_player) {
+    for (uint32_t n : {64u, 512u, 2048u}) {
+        for (uint32_t walls : {4u, 64u, 512u}) {
+            auto server = crowd(n, walls);
+            PlayerStore &players = BenchAccess::players(*server);
+            const PlayerStore saved = players;
+            InputPacket in{};
+            in.moveX = 1.0f;
+            in.moveZ = 1.0f;
+            bench::micro(
+                "integrate_player", n, walls, n, [&] { players = saved; },
+                [&] {
+                    for (uint32_t i = 0; i < n; ++i) {
+                        in.yaw = static_cast<float>(i) * 0.1f;
+                        BenchAccess::integratePlayer(*server, i, in);
+                    }
+                });
+        }
+    }
+}
+
+// Batched passes over every player, as integrateIdle runs them.
+BENCH_CASE(hotpath_resolve_walls) {
+    for (uint32_t n : {64u, 512u, 2048u}) {
+        for (uint32_t walls : {4u, 64u, 512u}) {
+            auto server = crowd(n, walls);
+            PlayerStore &players = BenchAccess::players(*server);
+            const PlayerStore saved = players;
+            bench::micro(
+                "resolve_walls", n, walls, 1, [&] { players = saved; },
+                [&] { BenchAccess::resolveWalls(*server); });
+        }
+    }
+}
+
+// walls is the platform count here.
+BENCH_CASE(hotpath_resolve_platforms) {
+    for (uint32_t n : {64u, 512u, 2048u}) {
+        for (uint32_t platforms : {4u, 64u, 512u}) {
+            auto server = crowd(n, 4);
+            BenchAccess::setPlatforms(*server, platforms);
+            PlayerStore &players = BenchAccess::players(*server);
+            const PlayerStore saved = players;
+            bench::micro(
+                "resolve_platforms", n, platforms, 1, [&] { players = saved; },
+                [&] { BenchAccess::resolvePlatforms(*server); });
+        }
+    }
+}
+
+// One ray against each of n spheres, and a shotgun's pellets against all n
+// at once through the SIMD kernel.
+BENCH_CASE(hotpath_ray_sphere) {
+    for (uint32_t n : {8u, 64u, 512u}) {
+        const SphereTargets targets = spheres(n);
+        float dir = 0.0f;
+        bench::micro(
+            "ray_sphere", n, 0, n, [] {},
+            [&] {
+                dir += 0.01f;
+                const float dx = 0.3f * std::sin(dir), dz = -std::sqrt(1.0f - dx * dx);
+                uint32_t hits = 0;
+                for (uint32_t i = 0; i < n; ++i) {
+                    float t;
+                    hits += raySphereIntersect(0.0f, 1.6f, 0.0f, dx, 0.0f, dz, targets.x[i], targets.y[i],
+                                               targets.z[i], kHitRadius, kShotgun.range, t);
+                }
+                bench::doNotOptimize(hits);
+            });
+
+        float dx[kShotgun.pellets], dy[kShotgun.pellets], dz[kShotgun.pellets];
+        PelletHit hits[kShotgun.pellets];
+        for (int p = 0; p < kShotgun.pellets; ++p) {
+            const float yaw = (static_cast<float>(p) - 4.0f) * kShotgun.spread * 0.25f;
+            dx[p] = -std::sin(yaw);
+            dy[p] = 0.0f;
+            dz[p] = -std::cos(yaw);
+        }
+        bench::micro(
+            "pellet_hits", n, 0, 1, [] {},
+            [&] {
+                nearestPelletHits(0.0f, 1.6f, 0.0f, dx, dy, dz, kShotgun.pellets, targets, kHitRadius,
+                                  kShotgun.range, hits);
+                bench::doNotOptimize(hits[0]);
+            });
+    }
+}
+
+// One shotgun shot through applyInput: movement, grid trace, pellet kernel
+// and damage, aimed at random in a crowd of n.
+BENCH_CASE(hotpath_volley) {
+    for (uint32_t n : {64u, 512u, 2048u}) {
+        for (uint32_t walls : {4u, 512u}) {
+            auto server = crowd(n, walls);
+            uint32_t state = 23;
+            bench::micro(
+                "volley", n, walls, 1, [] {},
+                [&] {
+                    const uint32_t shooter = static_cast<uint32_t>(benchRandom(state) * static_cast<float>(n));
+                    BenchAccess::fire(*server, shooter, 0, benchRandom(state) * 6.2831853f, 0.0f);
+                });
+        }
+    }
+}
+
+// Bot AI (target search, then processInput) for bots hunting kHumans players.
+BENCH_CASE(hotpath_update_bots) {
+    for (uint32_t bots : {16u, 128u, 512u}) {
+        for (uint32_t walls : {4u, 512u}) {
+            auto server = crowd(kHumans, walls, bots);
+            BenchAccess::updateBots(*server); // bots join
+            bench::micro(
+                "update_bots", bots, walls, 1, [] {},
+                [&] {
+                    BenchAccess::nextTick(*server);
+                    BenchAccess::updateBots(*server);
+                });
+        }
+    }
+}
+
+BENCH_CASE(hotpath_update_spiders) {
+    for (uint32_t n : {64u, 512u, 2048u}) {
+        for (uint32_t walls : {4u, 512u}) {
+            auto server = crowd(kHumans, walls);
+            BenchAccess::spawnSpiders(*server, n);
+            SpiderStore &spiders = BenchAccess::spiders(*server);
+            const SpiderStore saved = spiders;
+            bench::micro(
+                "update_spiders", n, walls, 1, [&] { spiders = saved; },
+                [&] {
+                    BenchAccess::nextTick(*server);
+                    BenchAccess::updateSpiders(*server);
+                });
+        }
+    }
+}
+
+// Full snapshot plus a delta per client against the previous tick.
+BENCH_CASE(hotpath_build_snapshot) {
+    for (uint32_t n : {64u, 256u, 1024u}) {
+        auto server = crowd(n, 4);
+        bench::micro(
+            "build_snapshot", n, 0, 1, [] {},
+            [&] {
+                BenchAccess::ackAll(*server, BenchAccess::tick(*server));
+                BenchAccess::nextTick(*server);
+                BenchAccess::buildSnapshot(*server);
+            });
+    }
+}
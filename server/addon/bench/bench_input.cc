@@ -0,0 +1,254 @@
+#include "bench.h"
+#include "../game_server.h"
+
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <thread>
+
+namespace {
+constexpr uint32_t kClients = 16;
+constexpr uint32_t kTicks = 1200;
+
+struct Lcg {
+    uint32_t state = 2024;
+    uint32_t next() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+};
+
+constexpr uint32_t kBatch = 512; // one lane
+constexpr uint32_t kBatches = 8000;
+
+void encodeWire(uint32_t seq, uint8_t *out) {
+    const float move[4] = {0.0f, 1.0f, 0.5f, 0.1f};
+    std::memcpy(out, &seq, 4);
+    std::memcpy(out + 4, move, sizeof(move));
+    out[20] = 0;
+    out[21] = 1;
+    out[22] = 0;
+    std::memcpy(out + 23, &seq, 4);
+}
+
+// Clients send one command per tick; each arrives 0..maxDelay ticks later and
+// 30% are sent twice. Before the jitter buffer every arrival was simulated on
+// the tick it arrived, so "arrivals" is what the old per-tick step count was.
+void runJitter(uint32_t maxDelay, uint32_t depth) {
+    auto server = std::make_unique<GameServer>();
+    GameConfig config{kClients, 40.0f, 0, {}};
+    config.inputBufferDepth = depth;
+    config.inputRate.rate = 0.0f; // faster than real time
+    server->startHeadless(config);
+    Lcg rng;
+    std::vector<std::vector<InputPacket>> inFlight(kTicks + 16);
+    for (uint32_t tick = 0; tick < kTicks; ++tick) {
+        for (uint32_t c = 0; c < kClients; ++c) {
+            InputPacket in{};
+            in.playerId = c + 1;
+            in.seq = tick + 1;
+            in.moveZ = 1.0f;
+            in.yaw = static_cast<float>(c);
+            const uint32_t copies = rng.next() % 10 < 3 ? 2 : 1;
+            for (uint32_t k = 0; k < copies; ++k) {
+                inFlight[tick + (maxDelay ? rng.next() % (maxDelay + 1) : 0)].push_back(in);
+            }
+        }
+    }
+
+    uint32_t maxArrivals = 0, emptyArrivals = 0, samples = 0;
+    double bufferedSum = 0.0;
+    for (uint32_t tick = 0; tick < kTicks; ++tick) {
+        std::vector<uint32_t> perClient(kClients, 0);
+        for (const InputPacket &in : inFlight[tick]) {
+            server->pushInput(in);
+            ++perClient[in.playerId - 1];
+        }
+        for (uint32_t n : perClient) {
+            maxArrivals = std::max(maxArrivals, n);
+            emptyArrivals += n == 0;
+        }
+        server->step(1.0f / 60.0f);
+        if (tick % 30 == 1 && tick > 60) {
+            for (const PlayerInputStats &p : server->inputStats()) bufferedSum += p.queue.buffered;
+            samples += kClients;
+        }
+    }
+    InputQueueStats total;
+    for (const PlayerInputStats &p : server->inputStats()) {
+        total.underruns += p.queue.underruns;
+        total.overflows += p.queue.overflows;
+        total.duplicates += p.queue.duplicates;
+        total.late += p.queue.late;
+    }
+    const double playerTicks = static_cast<double>(kClients) * kTicks;
+    std::printf("  delay<=%u depth=%u | arrivals/tick max %u, none %5.1f%% | buffer: starved %5.1f%% buffered avg %.2f "
+                "overflow %u dup %u late %u\n",
+                maxDelay, depth, maxArrivals, 100.0 * emptyArrivals / playerTicks, 100.0 * total.underruns / playerTicks,
+                samples ? bufferedSum / samples : 0.0, total.overflows, total.duplicates, total.late);
+}
+} // namespace
+
+// With the buffer each player moves at most one step per tick; the cost is
+// starved ticks (underruns) at low depth or added latency at high depth.
+BENCH_CASE(input_jitter) {
+    const uint32_t delays[] = {0, 2, 4};
+    const uint32_t depths[] = {1, 2, 3};
+    for (uint32_t delay : delays) {
+        for (uint32_t depth : depths) runJitter(delay, depth);
+    }
+}
+
+// Producer + consumer cost per input, batches of 512 (one tick's worth at a
+// heavy load). "lane" is the pushInput path minus the N-API call: addon.cc
+// parses, the lane checks the player's token bucket and copies the 40-byte
+// struct.
+BENCH_CASE(input_ring) {
+    uint8_t wire[kInputWireSize];
+    InputPacket packet;
+    uint64_t pushed = 0;
+    uint64_t drained = 0;
+
+    auto lanes = std::make_unique<InputLanes>();
+    InputRateLimit unlimited;
+    unlimited.rate = 0.0f;
+    double laneNs[2];
+    for (int limited = 0; limited < 2; ++limited) {
+        // Limited: 64 players, each well under its bucket.
+        InputRateLimit limit;
+        limit.rate = 1e9f;
+        limit.burst = 1e6f;
+        lanes->configure(limited ? limit : unlimited);
+        const uint64_t start = bench::nowNs();
+        for (uint32_t b = 0; b < kBatches; ++b) {
+            for (uint32_t i = 0; i < kBatch; ++i) {
+                encodeWire(b * kBatch + i, wire);
+                if (parseInputPacket(i % 64, wire, sizeof(wire), packet) &&
+                    lanes->push(InputLanes::kOwnerLane, packet)) {
+                    pushed += packet.seq;
+                }
+            }
+            lanes->drain([&](const InputPacket &in) { drained += in.seq; });
+        }
+        laneNs[limited] = static_cast<double>(bench::nowNs() - start) / (kBatch * kBatches);
+    }
+
+    std::printf("  lane          %6.1f ns/input  %6.1f M inputs/s\n", laneNs[0], 1e3 / laneNs[0]);
+    std::printf("  lane + bucket %6.1f ns/input  %6.1f M inputs/s  %s\n", laneNs[1], 1e3 / laneNs[1],
+                bench::verdict(pushed == drained));
+}
+
+namespace {
+// One client floods 4000 commands a tick ahead of 63 clients sending one
+// each, all through the owner lane, in real time.
+void runFlood(bool limited) {
+    constexpr uint32_t kHonest = 63;
+    constexpr uint32_t kFloodId = 1000;
+    constexpr uint32_t kFloodTicks = 120;
+    auto server = std::make_unique<GameServer>();
+    GameConfig config{kHonest + 1, 40.0f, 0, {}};
+    if (!limited) config.inputRate.rate = 0.0f;
+    server->startHeadless(config);
+    uint32_t honestSent = 0, honestQueued = 0, floodQueued = 0;
+    uint64_t next = bench::nowNs();
+    for (uint32_t tick = 0; tick < kFloodTicks; ++tick) {
+        InputPacket in{};
+        in.moveZ = 1.0f;
+        in.playerId = kFloodId;
+        for (uint32_t k = 0; k < 4000; ++k) {
+            in.seq = tick * 4000 + k + 1;
+            floodQueued += server->pushInput(in);
+        }
+        for (uint32_t c = 0; c < kHonest; ++c) {
+            in.playerId = c + 1;
+            in.seq = tick + 1;
+            ++honestSent;
+            honestQueued += server->pushInput(in);
+        }
+        server->step(1.0f / 60.0f);
+        next += 16666667;
+        while (bench::nowNs() < next) std::this_thread::yield();
+    }
+    std::unordered_map<uint32_t, InputDrops> drops;
+    server->inputLanes().collectDrops(drops);
+    uint32_t honestLaneFull = 0;
+    for (uint32_t c = 0; c < kHonest; ++c) honestLaneFull += drops[c + 1].laneFull;
+    std::printf("  %-9s honest queued %5.1f%% (lane full %u) | flooder queued %.0f/tick, rate limited %u\n",
+                limited ? "bucket" : "no bucket", 100.0 * honestQueued / honestSent, honestLaneFull,
+                static_cast<double>(floodQueued) / kFloodTicks, drops[kFloodId].rateLimited);
+}
+
+// Producers on their own threads and lanes while the consumer ticks; every
+// accepted command must come out exactly once.
+void runProducers(uint32_t producers) {
+    constexpr uint32_t kPerProducer = 200000;
+    auto server = std::make_unique<GameServer>();
+    GameConfig config{64, 40.0f, 0, {}};
+    config.inputRate.rate = 0.0f;
+    server->startHeadless(config);
+    std::atomic<uint32_t> running{producers};
+    std::atomic<uint64_t> accepted{0};
+    std::vector<std::thread> threads;
+    const uint64_t start = bench::nowNs();
+    for (uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            const uint32_t lane = server->inputLanes().claim();
+            uint64_t ok = 0;
+            InputPacket in{};
+            in.playerId = p + 1;
+            for (uint32_t k = 0; k < kPerProducer; ++k) {
+                in.seq = k + 1;
+                while (!server->pushInput(in, lane)) std::this_thread::yield();
+                ++ok;
+            }
+            server->inputLanes().release(lane);
+            accepted.fetch_add(ok);
+            running.fetch_sub(1);
+        });
+    }
+    while (running.load() > 0) {
+        server->step(1.0f / 60.0f);
+        std::this_thread::yield();
+    }
+    for (std::thread &t : threads) t.join();
+    server->step(1.0f / 60.0f);
+    const double seconds = static_cast<double>(bench::nowNs() - start) * 1e-9;
+    const uint64_t processed = server->profiler().inputsProcessed();
+    std::printf("  %u producers  %6.2f M inputs/s  accepted %llu processed %llu  %s\n", producers,
+                static_cast<double>(processed) / seconds * 1e-6, static_cast<unsigned long long>(accepted.load()),
+                static_cast<unsigned long long>(processed), bench::verdict(processed == accepted.load()));
+}
+} // namespace
+
+// Fairness: before per-player buckets a flooder filled the shared ring and the
+// other 63 clients' commands were refused behind it.
+BENCH_CASE(input_lanes) {
+    runFlood(false);
+    runFlood(true);
+    for (uint32_t producers : {1u, 2u, 4u, 7u}) runProducers(producers);
+}
+
+// Packets whose move or angles are NaN or infinite are refused at parse, so
+// they never reach the simulation's float-to-int conversions.
+BENCH_CASE(input_parse_finite) {
+    InputPacket packet{};
+    packet.seq = 1;
+    packet.moveZ = 1.0f;
+    packet.yaw = 0.5f;
+    uint8_t wire[kInputWireSize];
+    InputPacket parsed;
+    encodeInputPacket(packet, wire);
+    const bool plainAccepted = parseInputPacket(7, wire, sizeof(wire), parsed);
+    uint32_t refused = 0, cases = 0;
+    for (size_t field = 4; field < 20; field += 4) { // moveX, moveZ, yaw, pitch
+        for (float bad : {std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity(),
+                          -std::numeric_limits<float>::infinity()}) {
+            encodeInputPacket(packet, wire);
+            std::memcpy(wire + field, &bad, sizeof(bad));
+            refused += !parseInputPacket(7, wire, sizeof(wire), parsed);
+            ++cases;
+        }
+    }
+    std::printf("  finite packet accepted: %s, non-finite refused %u/%u  %s\n", plainAccepted ? "yes" : "no", refused,
+                cases, bench::verdict(plainAccepted && refused == cases));
+}
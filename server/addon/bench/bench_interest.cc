@@ -0,0 +1,120 @@
+#include "bench.h"
+#include "bench_access.h"
+#include "bench_clients.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+
+namespace {
+constexpr uint32_t kClients = 64;
+constexpr uint32_t kTicks = 600;
+constexpr uint32_t kAckLag = 6;
+
+// Decodes every client's slice as the client would and checks it holds
+// exactly its interest set (players within radius, plus last tick's that
+// are still within radius + margin) with the values of the full snapshot.
+void runInterest(float radius, float margin) {
+    auto server = std::make_unique<GameServer>();
+    GameConfig config{kClients, 50.0f, 0, {}};
+    config.inputRate.rate = 0.0f;
+    config.interestRadius = radius;
+    config.interestMargin = margin;
+    server->startHeadless(config);
+
+    std::vector<SnapshotHistory> clientHistory(kClients);
+    std::vector<std::vector<uint32_t>> expected(kClients), previous(kClients);
+    SnapshotHistory noHistory;
+    SnapshotHeader header{};
+    std::vector<EntitySnapshot> truth, decoded;
+    // Each client acks the snapshot it decoded kAckLag ticks ago, if any.
+    std::vector<std::array<uint32_t, kAckLag>> decodedTicks(kClients, std::array<uint32_t, kAckLag>{});
+    std::vector<uint32_t> acks(kClients, 0);
+    uint64_t bytes = 0, visible = 0, churn = 0, slices = 0;
+    bool match = true;
+    const float enter2 = radius * radius;
+    const float exit2 = (radius + margin) * (radius + margin);
+    for (uint32_t tick = 0; tick < kTicks; ++tick) {
+        if (tick == 2) {
+            // Everyone has joined at the spawn points; spread them over the map.
+            uint32_t state = 41;
+            PlayerStore &players = BenchAccess::players(*server);
+            for (uint32_t i = 0; i < players.size(); ++i) {
+                BenchAccess::place(*server, i, benchRandom(state) * 96.0f - 48.0f, benchRandom(state) * 96.0f - 48.0f);
+            }
+        }
+        for (uint32_t c = 0; c < kClients; ++c) {
+            acks[c] = decodedTicks[c][tick % kAckLag];
+            decodedTicks[c][tick % kAckLag] = 0;
+        }
+        bench::pushClientInputs(*server, kClients, tick, acks.data());
+        server->step(kBenchDt);
+
+        const SnapshotView view = server->getSnapshot();
+        const uint8_t *data = view.frame()->data.data();
+        match &= decodeSnapshot(data + view.frame()->full.offset, view.frame()->full.size, noHistory, header, truth);
+        const PlayerStore &players = BenchAccess::players(*server);
+        for (uint32_t c = 0; c < kClients; ++c) {
+            const uint32_t id = c + 1;
+            const uint32_t self = BenchAccess::slotOf(*server, id);
+            const SnapshotSlice slice = view.sliceFor(id);
+            if (self == kNoSlot || slice.clientId != id) continue;
+
+            std::vector<uint32_t> &want = expected[c];
+            want.clear();
+            for (uint32_t j = 0; j < players.size(); ++j) {
+                const float dx = players.x[j] - players.x[self];
+                const float dz = players.z[j] - players.z[self];
+                const float d2 = dx * dx + dz * dz;
+                const uint32_t other = players.info[j].id;
+                const bool was = std::binary_search(previous[c].begin(), previous[c].end(), other);
+                if (radius <= 0.0f || d2 <= enter2 || (was && d2 <= exit2)) want.push_back(other);
+            }
+            std::sort(want.begin(), want.end());
+
+            match &= decodeSnapshot(data + slice.offset, slice.size, clientHistory[c], header, decoded);
+            match &= decoded.size() == want.size();
+            for (size_t k = 0; match && k < decoded.size(); ++k) {
+                const auto it = std::lower_bound(truth.begin(), truth.end(), decoded[k].id,
+                                                 [](const EntitySnapshot &a, uint32_t v) { return a.id < v; });
+                match &= it != truth.end() && it->id == want[k];
+                if (!match) break;
+                EntitySnapshot e = *it;
+                if (e.id != id) e.lastSeq = 0; // only the client's own is sent
+                match &= diffFields(e, decoded[k]) == 0;
+            }
+            clientHistory[c].begin(header.tick) = decoded;
+            decodedTicks[c][tick % kAckLag] = header.tick;
+
+            std::vector<uint32_t> diff;
+            std::set_symmetric_difference(previous[c].begin(), previous[c].end(), want.begin(), want.end(),
+                                          std::back_inserter(diff));
+            if (tick > 2) churn += diff.size(); // after the spread
+            previous[c].swap(want);
+            bytes += slice.size;
+            visible += decoded.size();
+            ++slices;
+        }
+    }
+    char label[48];
+    if (radius > 0.0f) {
+        std::snprintf(label, sizeof(label), "radius %.0f margin %.0f", radius, margin);
+    } else {
+        std::snprintf(label, sizeof(label), "everyone");
+    }
+    const double n = static_cast<double>(std::max<uint64_t>(1, slices));
+    const LatencyHistogram &snapshot = server->profiler().phase(TickPhase::Snapshot);
+    std::printf("  %-20s %6.0f B/client/tick  visible %5.1f  set changes %.3f/client/tick  snapshot %6.1f us/tick  %s\n",
+                label, bytes / n, visible / n, churn / n, static_cast<double>(snapshot.sum()) / snapshot.count() / 1e3,
+                bench::verdict(match));
+}
+} // namespace
+
+// 64 clients roaming a 100 x 100 m map (acking 6 ticks behind) with and without
+// distance-based interest sets; the margin is the hysteresis band.
+BENCH_CASE(interest_sets) {
+    runInterest(0.0f, 0.0f);
+    runInterest(20.0f, 0.0f);
+    runInterest(20.0f, 5.0f);
+    runInterest(35.0f, 5.0f);
+}
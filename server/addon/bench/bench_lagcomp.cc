@@ -0,0 +1,97 @@
+#include "bench.h"
+#include "bench_access.h"
+
+#include <cmath>
+#include <memory>
+
+namespace {
+constexpr float kStrafeStep = 0.2f; // 12 m/s at 60 Hz
+
+// A target strafes across z = -6 while a shooter at z = 6 aims where it was
+// lagTicks ago, as a client with that much latency would. Returns the
+// damage dealt.
+int32_t shootLagged(uint32_t maxRewind, uint32_t lagTicks) {
+    auto server = std::make_unique<GameServer>();
+    GameConfig config{2, 40.0f, 0, {}};
+    config.inputRate.rate = 0.0f;
+    config.maxRewindTicks = maxRewind;
+    server->startHeadless(config);
+    InputPacket join{};
+    join.playerId = 1;
+    server->pushInput(join);
+    join.playerId = 2;
+    server->pushInput(join);
+    server->step(kBenchDt);
+    const uint32_t shooter = BenchAccess::slotOf(*server, 1);
+    const uint32_t target = BenchAccess::slotOf(*server, 2);
+
+    constexpr uint32_t kSteps = 40;
+    auto targetX = [](uint32_t step) { return -4.0f + kStrafeStep * static_cast<float>(step); };
+    uint32_t seenTick = 0;
+    for (uint32_t step = 0; step < kSteps; ++step) {
+        BenchAccess::place(*server, shooter, 0.0f, 6.0f);
+        BenchAccess::place(*server, target, targetX(step), -6.0f);
+        server->step(kBenchDt);
+        if (step == kSteps - 1 - lagTicks) seenTick = BenchAccess::tick(*server);
+    }
+    // Aim at the target as of seenTick: forward is (-sin yaw, -cos yaw).
+    const float dx = targetX(kSteps - 1 - lagTicks);
+    const float dz = -12.0f;
+    BenchAccess::fire(*server, shooter, seenTick, std::atan2(-dx, -dz), 0.0f);
+    return 100 - BenchAccess::players(*server).health[target];
+}
+
+// Shots from random players at random headings in a room of n moving
+// players, resolved against current positions (maxRewind 0) or rewound
+// lagTicks; plus the per-tick history write.
+void shotCost(uint32_t n, uint32_t maxRewind, uint32_t lagTicks) {
+    auto server = std::make_unique<GameServer>();
+    BenchAccess::populate(*server, n);
+    PlayerStore &players = BenchAccess::players(*server);
+    BenchAccess::startHistory(*server);
+    for (uint32_t t = 0; t < 40; ++t) server->step(kBenchDt);
+    for (uint32_t i = 0; i < n; ++i) players.health[i] = 1 << 30; // nobody dies
+    BenchAccess::setMaxRewind(*server, maxRewind);
+
+    uint32_t state = 7;
+    const int shots = 20000;
+    uint64_t t0 = bench::nowNs();
+    for (int s = 0; s < shots; ++s) {
+        state = state * 1664525u + 1013904223u;
+        const uint32_t slot = (state >> 8) % n;
+        const float yaw = static_cast<float>(state >> 16) * (6.2831853f / 65536.0f);
+        BenchAccess::fire(*server, slot, BenchAccess::tick(*server) - lagTicks, yaw, 0.0f);
+    }
+    const double shotNs = static_cast<double>(bench::nowNs() - t0) / shots;
+
+    const int records = 20000;
+    t0 = bench::nowNs();
+    for (int r = 0; r < records; ++r) BenchAccess::recordPositions(*server);
+    const double recordNs = static_cast<double>(bench::nowNs() - t0) / records;
+    std::printf("  n=%-4u rewind %2u ticks  %7.1f ns/shot  history write %6.1f ns/tick\n", n,
+                std::min(maxRewind, lagTicks), shotNs, recordNs);
+}
+} // namespace
+
+// Hits against a strafing target (12 m/s) with and without rewinding, then
+// the per-shot and per-tick cost of lag compensation.
+BENCH_CASE(lag_comp) {
+    struct Case {
+        uint32_t maxRewind, lag;
+        bool hit;
+    };
+    const Case cases[] = {{0, 0, true}, {0, 8, false}, {12, 8, true}, {12, 20, false}, {31, 20, true}};
+    bool ok = true;
+    for (const Case &c : cases) {
+        const int32_t damage = shootLagged(c.maxRewind, c.lag);
+        ok &= (damage > 0) == c.hit;
+        std::printf("  maxRewind %2u lag %2u ticks: damage %3d (%s expected)\n", c.maxRewind, c.lag, damage,
+                    c.hit ? "hit" : "miss");
+    }
+    std::printf("  %s\n", bench::verdict(ok));
+    for (uint32_t n : {64u, 256u}) {
+        shotCost(n, 0, 0);
+        shotCost(n, 12, 8);
+        shotCost(n, 31, 30);
+    }
+}
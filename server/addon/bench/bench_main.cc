@@ -0,0 +1,124 @@
+#include "bench.h"
+#include "../pellet_kernel.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <tuple>
+#include <utility>
+
+namespace {
+std::atomic<uint64_t> gAllocations{0};
+const char *gCurrent = nullptr;
+std::vector<const char *> gFailed; // cases that called fail(), in run order
+
+std::vector<std::pair<const char *, bench::BenchFn>> &registry() {
+    static std::vector<std::pair<const char *, bench::BenchFn>> cases;
+    return cases;
+}
+
+std::vector<bench::MicroResult> &results() {
+    static std::vector<bench::MicroResult> kept;
+    return kept;
+}
+
+// Sorted by name and parameters so reports from different builds diff
+// line by line whatever order the cases were linked in.
+bool writeJson(const char *path) {
+    std::vector<bench::MicroResult> sorted = results();
+    std::sort(sorted.begin(), sorted.end(), [](const bench::MicroResult &a, const bench::MicroResult &b) {
+        const int byName = std::strcmp(a.name, b.name);
+        if (byName != 0) return byName < 0;
+        return std::tie(a.entities, a.walls) < std::tie(b.entities, b.walls);
+    });
+    std::FILE *file = std::fopen(path, "w");
+    if (!file) return false;
+    std::fprintf(file, "{\n  \"version\": 1,\n  \"pelletKernel\": \"%s\",\n  \"results\": [", pelletKernelName());
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        const bench::MicroResult &r = sorted[i];
+        std::fprintf(file,
+                     "%s\n    {\"name\": \"%s\", \"entities\": %u, \"walls\": %u, \"nsPerOp\": %.2f, "
+                     "\"allocsPerOp\": %.3f}",
+                     i ? "," : "", r.name, r.entities, r.walls, r.nsPerOp, r.allocsPerOp);
+    }
+    std::fprintf(file, "\n  ]\n}\n");
+    return std::fclose(file) == 0;
+}
+} // namespace
+
+void *operator new(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void bench::fail() {
+    if (gFailed.empty() || gFailed.back() != gCurrent) gFailed.push_back(gCurrent);
+}
+
+uint64_t bench::allocations() {
+    return gAllocations.load(std::memory_order_relaxed);
+}
+
+void bench::report(const MicroResult &result) {
+    std::printf("  %-18s entities=%-5u walls=%-5u %10.1f ns/op %8.3f allocs/op\n", result.name, result.entities,
+                result.walls, result.nsPerOp, result.allocsPerOp);
+    results().push_back(result);
+}
+
+bench::Registrar::Registrar(const char *name, BenchFn fn) {
+    registry().emplace_back(name, fn);
+}
+
+// Usage: bench [--json PATH] [filter]  runs every case whose name contains
+// filter; --json also writes the hot-path results (cases hotpath_*) to PATH.
+// Exits 1 if any case's correctness check failed.
+int main(int argc, char **argv) {
+    const char *json = nullptr;
+    const char *filter = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--json") && i + 1 < argc) {
+            json = argv[++i];
+        } else {
+            filter = argv[i];
+        }
+    }
+    for (const auto &entry : registry()) {
+        if (filter && std::strstr(entry.first, filter) == nullptr) continue;
+        std::printf("%s\n", entry.first);
+        gCurrent = entry.first;
+        entry.second();
+    }
+    if (json && !writeJson(json)) {
+        std::fprintf(stderr, "cannot write %s\n", json);
+        return 1;
+    }
+    if (!gFailed.empty()) {
+        std::fprintf(stderr, "failed:");
+        for (const char *name : gFailed) std::fprintf(stderr, " %s", name);
+        std::fprintf(stderr, "\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include "bench.h"
+#include "bench_access.h"
+#include "bench_clients.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace {
+constexpr uint32_t kClients = 32;
+constexpr uint32_t kTicks = 300;
+constexpr int kReps = 50;
+
+// count walls and as many platforms scattered inside the perimeter, plus
+// spawn points in the open.
+MapGeometry scatterMap(uint32_t count) {
+    MapGeometry map;
+    const float h = map.worldHalfExtent;
+    map.walls = {{-h, h, h - 1.0f, h}, {-h, h, -h, -h + 1.0f}, {-h, -h + 1.0f, -h, h}, {h - 1.0f, h, -h, h}};
+    uint32_t state = 29;
+    for (uint32_t i = 0; i < count; ++i) {
+        const float x = benchRandom(state) * 90.0f - 45.0f;
+        const float z = benchRandom(state) * 90.0f - 45.0f;
+        const float w = i % 2 ? 0.3f : 1.0f + benchRandom(state) * 4.0f;
+        map.walls.push_back({x, x + w, z, z + (i % 2 ? 3.0f : w)});
+        const float side = 1.0f + benchRandom(state) * 2.0f;
+        map.platforms.push_back({x + 2.0f, x + 2.0f + side, z, z + side, 1.2f + benchRandom(state) * 2.0f});
+    }
+    for (uint32_t i = 0; i < 16; ++i) {
+        const float x = benchRandom(state) * 80.0f - 40.0f;
+        map.spawns.push_back({x, benchRandom(state) * 80.0f - 40.0f});
+    }
+    return map;
+}
+
+long fileSize(const std::string &path) {
+    std::FILE *f = std::fopen(path.c_str(), "rb");
+    if (!f) return 0;
+    std::fseek(f, 0, SEEK_END);
+    const long size = std::ftell(f);
+    std::fclose(f);
+    return size;
+}
+
+template <typename Op>
+double usPerCall(Op op) {
+    const uint64_t t0 = bench::nowNs();
+    for (int r = 0; r < kReps; ++r) op();
+    return static_cast<double>(bench::nowNs() - t0) / kReps / 1e3;
+}
+
+void runMap(uint32_t count) {
+    const std::string path = "/tmp/burstfire_bench.bfmap";
+    const MapGeometry geometry = scatterMap(count);
+    if (!writeMapFile(path, geometry)) {
+        std::printf("  cannot write %s\n", path.c_str());
+        return;
+    }
+    std::string error;
+    const double openUs = usPerCall([&] {
+        std::shared_ptr<const MapFile> map = MapFile::open(path, &error); // last user: mapped afresh each time
+        bench::doNotOptimize(map);
+    });
+    std::shared_ptr<const MapFile> held = MapFile::open(path, &error);
+    if (!held) {
+        std::printf("  %s\n", error.c_str());
+        return;
+    }
+
+    // Rooms started from the file and from the same geometry in memory must
+    // play out identically.
+    GameConfig config{kClients, geometry.worldHalfExtent, 0, {}};
+    config.inputRate.rate = 0.0f;
+    config.seed = 99;
+    auto fromFile = std::make_unique<GameServer>();
+    auto fromGeometry = std::make_unique<GameServer>();
+    GameConfig fileConfig = config;
+    fileConfig.mapPath = path;
+    fromFile->startHeadless(fileConfig);
+    fromGeometry->startHeadless(config);
+    BenchAccess::loadGeometry(*fromGeometry, geometry);
+    bool match = true;
+    for (uint32_t tick = 0; tick < kTicks; ++tick) {
+        bench::pushClientInputs(*fromFile, kClients, tick);
+        bench::pushClientInputs(*fromGeometry, kClients, tick);
+        fromFile->step(kBenchDt);
+        fromGeometry->step(kBenchDt);
+        match &= fromFile->stateHash() == fromGeometry->stateHash();
+    }
+
+    const double loadUs = usPerCall([&] { BenchAccess::loadMap(*fromFile, path); });
+    const double buildUs = usPerCall([&] { BenchAccess::loadGeometry(*fromGeometry, geometry); });
+    std::printf("  %5u walls + %5u platforms  %7ld B  open %7.1f us  room map load %6.1f us (built %7.1f us)  %s\n",
+                count + 4, count, fileSize(path), openUs, loadUs, buildUs, bench::verdict(match));
+    std::remove(path.c_str());
+}
+} // namespace
+
+// Room map setup from a mapped file (baked grids used in place; the mapping
+// is shared while any room holds it) vs copying the geometry in and building
+// the grids, and the cost of mapping and checking a file nobody holds.
+BENCH_CASE(map_file) {
+    runMap(10);
+    runMap(500);
+    runMap(5000);
+}
@@ -0,0 +1,109 @@
+#include "bench.h"
+#include "bench_access.h"
+
+#include <cmath>
+#include <memory>
+
+namespace {
+constexpr uint32_t kShooters = 64;
+constexpr uint32_t kRays = kShooters * kShotgun.pellets;
+constexpr int kReps = 200;
+
+struct Ray {
+    float ox, oy, oz, dx, dy, dz;
+};
+
+// count walls and as many platforms scattered over the map, on top of the perimeter.
+void scatterGeometry(GameServer &server, uint32_t count) {
+    std::vector<Wall> &walls = BenchAccess::walls(server);
+    std::vector<Platform> &platforms = BenchAccess::platforms(server);
+    walls.resize(4);
+    platforms.clear();
+    uint32_t state = 61;
+    for (uint32_t i = 0; i < count; ++i) {
+        const float x = benchRandom(state) * 78.0f - 39.0f;
+        const float z = benchRandom(state) * 78.0f - 39.0f;
+        const float w = i % 2 ? 0.3f : 1.0f + benchRandom(state) * 4.0f;
+        walls.push_back({x, x + w, z, z + (i % 2 ? 3.0f : w)});
+        const float side = 1.0f + benchRandom(state) * 2.0f;
+        platforms.push_back({x + 2.0f, x + 2.0f + side, z, z + side, 1.2f + benchRandom(state) * 2.0f});
+    }
+    BenchAccess::buildColliders(server);
+}
+
+// One tick's shotgun pellets: kShooters players at eye height, aimed
+// anywhere, with the gun's spread.
+std::vector<Ray> volleyRays() {
+    std::vector<Ray> rays;
+    uint32_t state = 17;
+    for (uint32_t s = 0; s < kShooters; ++s) {
+        const float x = benchRandom(state) * 80.0f - 40.0f;
+        const float z = benchRandom(state) * 80.0f - 40.0f;
+        const float yaw = benchRandom(state) * 6.2831853f;
+        const float pitch = (benchRandom(state) - 0.5f) * 0.3f;
+        for (int p = 0; p < kShotgun.pellets; ++p) {
+            const float y = yaw + (benchRandom(state) - 0.5f) * 2.0f * kShotgun.spread;
+            const float pt = pitch + (benchRandom(state) - 0.5f) * 1.2f * kShotgun.spread;
+            rays.push_back({x, 1.2f, z, -std::sin(y) * std::cos(pt), std::sin(pt), -std::cos(y) * std::cos(pt)});
+        }
+    }
+    return rays;
+}
+
+// us to cast every ray, and the distances.
+double castAll(const GameServer &server, const std::vector<Ray> &rays, std::vector<float> &out) {
+    out.assign(rays.size(), 0.0f);
+    const uint64_t t0 = bench::nowNs();
+    for (int r = 0; r < kReps; ++r) {
+        for (size_t i = 0; i < rays.size(); ++i) {
+            const Ray &ray = rays[i];
+            out[i] = BenchAccess::staticRayDistance(server, ray.ox, ray.oy, ray.oz, ray.dx, ray.dy, ray.dz,
+                                                    kShotgun.range);
+        }
+    }
+    return static_cast<double>(bench::nowNs() - t0) / kReps / 1e3;
+}
+
+// A shot at a player 6 m away with a wall halfway (or not) in between;
+// health taken.
+int32_t shotThroughWall(bool wall) {
+    auto server = std::make_unique<GameServer>();
+    BenchAccess::populate(*server, 2);
+    BenchAccess::place(*server, 0, 0.0f, 0.0f);
+    BenchAccess::place(*server, 1, 0.0f, -6.0f);
+    if (wall) BenchAccess::walls(*server).push_back({-2.0f, 2.0f, -3.5f, -3.0f});
+    BenchAccess::buildColliders(*server);
+    BenchAccess::fire(*server, 0, 0, 0.0f, 0.0f);
+    return 100 - BenchAccess::players(*server).health[1];
+}
+
+void runOcclusion(uint32_t count) {
+    auto server = std::make_unique<GameServer>();
+    BenchAccess::populate(*server, kShooters);
+    scatterGeometry(*server, count);
+    const std::vector<Ray> rays = volleyRays();
+    std::vector<float> viaGrid, viaLoop;
+    BenchAccess::setColliderGrids(*server, true);
+    const double gridUs = castAll(*server, rays, viaGrid);
+    BenchAccess::setColliderGrids(*server, false);
+    const double loopUs = castAll(*server, rays, viaLoop);
+    uint32_t blocked = 0;
+    for (float d : viaGrid) blocked += d < kShotgun.range;
+    std::printf("  %5u walls + %5u platforms  %u rays: loop %8.1f us  grid %6.1f us per tick  (%3u stopped short)  %s\n",
+                count + 4, count, kRays, loopUs, gridUs, blocked, bench::verdict(viaGrid == viaLoop));
+}
+} // namespace
+
+// Pellet occlusion: every pellet of 64 shotgun shots in one tick cast against
+// walls and platforms, with each collider looped over and through the
+// collider grid; both must give the same distances. Then a shot through a
+// wall must do no damage.
+BENCH_CASE(hitscan_occlusion) {
+    runOcclusion(10);
+    runOcclusion(500);
+    runOcclusion(5000);
+    const int32_t open = shotThroughWall(false);
+    const int32_t walled = shotThroughWall(true);
+    std::printf("  shot at 6 m: %d damage in the open, %d through a wall  %s\n", open, walled,
+                bench::verdict(open > 0 && walled == 0));
+}
@@ -0,0 +1,104 @@
+#include "bench.h"
+#include "../pellet_kernel.h"
+
+#include <cmath>
+
+namespace {
+constexpr float kHitRadius = 0.6f;
+constexpr float kRange = 22.0f;
+constexpr float kSpread = 0.07f;
+constexpr int kPellets = 8;
+
+struct Lcg {
+    uint32_t state = 4242;
+    float next() {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8) / static_cast<float>(1u << 24);
+    }
+};
+
+struct Volley {
+    float dx[kPellets], dy[kPellets], dz[kPellets];
+};
+
+// Targets scattered in front of a shooter at the origin, clustered enough that
+// most pellets hit something and many rays pass through several spheres.
+void makeScene(Lcg &rng, size_t n, float depth, SphereTargets &targets) {
+    targets.clear();
+    for (size_t i = 0; i < n; ++i) {
+        targets.push(static_cast<uint32_t>(i), rng.next() * 4.0f - 2.0f, rng.next() * 1.0f - 0.5f,
+                     -1.0f - rng.next() * depth);
+    }
+}
+
+Volley makeVolley(Lcg &rng) {
+    Volley v{};
+    for (int p = 0; p < kPellets; ++p) {
+        const float yaw = (rng.next() * 2.0f - 1.0f) * kSpread;
+        const float pitch = (rng.next() * 2.0f - 1.0f) * kSpread * 0.6f;
+        v.dx[p] = -std::sin(yaw) * std::cos(pitch);
+        v.dy[p] = std::sin(pitch);
+        v.dz[p] = -std::cos(yaw) * std::cos(pitch);
+    }
+    return v;
+}
+} // namespace
+
+// SIMD kernel vs the scalar reference: every pellet must pick the same target
+// at the same distance, including target counts that leave a scalar tail.
+BENCH_CASE(pellet_kernel_check) {
+    Lcg rng;
+    SphereTargets targets;
+    PelletHit simd[kPellets], scalar[kPellets];
+    uint64_t pellets = 0, hits = 0, mismatches = 0;
+    for (int scene = 0; scene < 2000; ++scene) {
+        makeScene(rng, static_cast<size_t>(scene % 67), 6.0f + rng.next() * 20.0f, targets);
+        const Volley v = makeVolley(rng);
+        nearestPelletHits(0.0f, 0.0f, 0.0f, v.dx, v.dy, v.dz, kPellets, targets, kHitRadius, kRange, simd);
+        nearestPelletHitsScalar(0.0f, 0.0f, 0.0f, v.dx, v.dy, v.dz, kPellets, targets, kHitRadius, kRange, scalar);
+        for (int p = 0; p < kPellets; ++p) {
+            ++pellets;
+            if (scalar[p].target != kPelletMiss) ++hits;
+            if (simd[p].target != scalar[p].target ||
+                (scalar[p].target != kPelletMiss && simd[p].dist != scalar[p].dist)) {
+                ++mismatches;
+            }
+        }
+    }
+    std::printf("  %s kernel: %llu pellets, %llu hits, %llu mismatches vs scalar%s\n", pelletKernelName(),
+                static_cast<unsigned long long>(pellets), static_cast<unsigned long long>(hits),
+                static_cast<unsigned long long>(mismatches), mismatches ? "  FAILED" : "");
+    if (mismatches) bench::fail();
+}
+
+BENCH_CASE(pellet_kernel) {
+    std::printf(" one %d-pellet volley vs N targets, %s kernel\n", kPellets, pelletKernelName());
+    const size_t sizes[] = {8, 16, 64, 256, 1024};
+    for (size_t n : sizes) {
+        Lcg rng;
+        SphereTargets targets;
+        makeScene(rng, n, 20.0f, targets);
+        Volley volleys[64];
+        for (auto &v : volleys) v = makeVolley(rng);
+        PelletHit out[kPellets];
+        const int iters = static_cast<int>(std::max<size_t>(2000, 400000 / n));
+
+        uint64_t t0 = bench::nowNs();
+        for (int it = 0; it < iters; ++it) {
+            const Volley &v = volleys[it & 63];
+            nearestPelletHitsScalar(0.0f, 0.0f, 0.0f, v.dx, v.dy, v.dz, kPellets, targets, kHitRadius, kRange, out);
+            bench::doNotOptimize(out[0]);
+        }
+        const double scalarNs = static_cast<double>(bench::nowNs() - t0) / iters;
+
+        t0 = bench::nowNs();
+        for (int it = 0; it < iters; ++it) {
+            const Volley &v = volleys[it & 63];
+            nearestPelletHits(0.0f, 0.0f, 0.0f, v.dx, v.dy, v.dz, kPellets, targets, kHitRadius, kRange, out);
+            bench::doNotOptimize(out[0]);
+        }
+        const double simdNs = static_cast<double>(bench::nowNs() - t0) / iters;
+        std::printf("  targets=%-5zu scalar %9.1f ns  simd %9.1f ns  (%.1fx, %.2f ns/pellet-target)\n", n, scalarNs,
+                    simdNs, scalarNs / simdNs, simdNs / (kPellets * static_cast<double>(n)));
+    }
+}
@@ -0,0 +1,68 @@
+#include "bench.h"
+#include "bench_clients.h"
+#include "../tick_profiler.h"
+
+#include <memory>
+
+namespace {
+struct Lcg {
+    uint32_t state = 31337;
+    uint32_t next() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+};
+} // namespace
+
+// Cost of the always-on instrumentation and how far histogram percentiles
+// land from exact ones on a long-tailed sample.
+BENCH_CASE(tick_profiler) {
+    Lcg rng;
+    std::vector<uint64_t> samples(200000);
+    for (uint64_t &s : samples) {
+        const uint32_t r = rng.next();
+        s = 20000 + r % 200000 + ((r & 0xFF) == 0 ? r % 20000000 : 0);
+    }
+    LatencyHistogram hist;
+    uint64_t t0 = bench::nowNs();
+    for (uint64_t s : samples) hist.record(s);
+    const double recordNs = static_cast<double>(bench::nowNs() - t0) / samples.size();
+    t0 = bench::nowNs();
+    for (int i = 0; i < 1000; ++i) bench::doNotOptimize(TickProfiler::now());
+    const double clockNs = static_cast<double>(bench::nowNs() - t0) / 1000.0;
+    std::printf("  record %.1f ns, clock read %.1f ns (a tick takes 5 reads and 5 records)\n", recordNs, clockNs);
+
+    std::sort(samples.begin(), samples.end());
+    const double ps[] = {0.5, 0.99, 0.999};
+    for (double p : ps) {
+        const uint64_t exact = bench::percentile(samples, p);
+        const uint64_t approx = hist.percentile(p);
+        std::printf("  p%-5g exact %9llu hist %9llu (%+.2f%%)\n", p * 100.0, static_cast<unsigned long long>(exact),
+                    static_cast<unsigned long long>(approx),
+                    100.0 * (static_cast<double>(approx) - static_cast<double>(exact)) / static_cast<double>(exact));
+    }
+    std::printf("  max   exact %9llu hist %9llu\n", static_cast<unsigned long long>(samples.back()),
+                static_cast<unsigned long long>(hist.max()));
+
+    // Per-phase breakdown of a 64-client room, as getStats() reports it.
+    auto server = std::make_unique<GameServer>();
+    GameConfig config{64, 40.0f, 0, {}};
+    config.inputRate.rate = 0.0f; // faster than real time
+    server->startHeadless(config);
+    for (uint32_t tick = 0; tick < 600; ++tick) {
+        bench::pushClientInputs(*server, 64, tick);
+        server->step(1.0f / 60.0f);
+    }
+    const TickProfiler &prof = server->profiler();
+    for (size_t i = 0; i < kTickPhaseCount; ++i) {
+        const LatencyHistogram &h = prof.phase(static_cast<TickPhase>(i));
+        std::printf("  %-9s p50=%-8llu p99=%-8llu p999=%-8llu max=%llu (ns)\n", tickPhaseName(static_cast<TickPhase>(i)),
+                    static_cast<unsigned long long>(h.percentile(0.5)), static_cast<unsigned long long>(h.percentile(0.99)),
+                    static_cast<unsigned long long>(h.percentile(0.999)), static_cast<unsigned long long>(h.max()));
+    }
+    std::printf("  ticks %llu overruns %llu inputs %llu dropped %llu snapshot bytes %llu\n",
+                static_cast<unsigned long long>(prof.ticks()), static_cast<unsigned long long>(prof.overruns()),
+                static_cast<unsigned long long>(prof.inputsProcessed()),
+                static_cast<unsigned long long>(prof.inputsDropped()),
+                static_cast<unsigned long long>(prof.snapshotBytes()));
+}
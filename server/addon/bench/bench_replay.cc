@@ -0,0 +1,74 @@
+#include "bench.h"
+#include "bench_clients.h"
+#include "../replay.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+namespace {
+constexpr uint32_t kTicks = 3600; // one minute at 60 Hz
+
+// Records a minute of 48 clients and 16 bots fighting (so spread and
+// respawns draw from the room RNG), or just runs it without a path.
+// Returns the mean tick cost.
+double record(const char *path, uint32_t seed) {
+    auto server = std::make_unique<GameServer>();
+    GameConfig config{64, 40.0f, 16, {}};
+    config.inputRate.rate = 0.0f; // faster than real time
+    config.seed = seed;
+    if (path) config.recordPath = path;
+    server->startHeadless(config);
+    const uint64_t start = bench::nowNs();
+    for (uint32_t tick = 0; tick < kTicks; ++tick) {
+        bench::pushClientInputs(*server, 48, tick);
+        server->step(1.0f / 60.0f);
+    }
+    return static_cast<double>(bench::nowNs() - start) / kTicks;
+}
+
+// Overwrites the u32 at offset, e.g. the header seed (8) as if the room RNG
+// had been seeded differently.
+bool patch(const char *path, long offset, uint32_t value) {
+    std::FILE *f = std::fopen(path, "r+b");
+    if (!f) return false;
+    const bool ok = std::fseek(f, offset, SEEK_SET) == 0 && std::fwrite(&value, 4, 1, f) == 1;
+    std::fclose(f);
+    return ok;
+}
+
+// Header without a map path, then the first tick's number and dt.
+constexpr long kFirstInputCount = 40 + 8;
+
+void report(const char *label, const ReplayResult &r) {
+    std::printf("  %-14s ticks %u inputs %llu  %.0f ticks/s (%.0fx real time)  mismatched ticks %u (first %u)\n",
+                label, r.ticks, static_cast<unsigned long long>(r.inputs), r.ticks / r.seconds,
+                r.ticks / r.seconds / 60.0, r.mismatches, r.firstMismatchTick);
+}
+} // namespace
+
+// Record then replay; the replay must reproduce every tick's state hash.
+// With the seed patched the first shot or respawn diverges; a log claiming an
+// older version is refused; with a corrupt input count the log is cut short
+// there instead of allocating it.
+BENCH_CASE(replay) {
+    const char *path = "/tmp/burstfire_bench.bfil";
+    const double plainNs = record(nullptr, 1234);
+    const double tickNs = record(path, 1234);
+    std::printf("  %u ticks: %.1f us/tick recording, %.1f us/tick without\n", kTicks, tickNs * 1e-3, plainNs * 1e-3);
+    const ReplayResult same = replayInputLog(path);
+    report("replay", same);
+    patch(path, 8, 4321);
+    const ReplayResult patched = replayInputLog(path);
+    report("other seed", patched);
+    patch(path, 4, 3); // recorded before the last simulation change
+    const bool oldRefused = !replayInputLog(path).opened;
+    patch(path, 4, 4);
+    patch(path, kFirstInputCount, 0xFFFFFFFFu);
+    const ReplayResult corrupt = replayInputLog(path);
+    report("corrupt count", corrupt);
+    std::remove(path);
+    std::printf("  older log version refused: %s\n", oldRefused ? "yes" : "no");
+    std::printf("  %s\n", bench::verdict(oldRefused && same.opened && same.ticks == kTicks && same.mismatches == 0 &&
+                                          patched.mismatches > 0 && corrupt.ticks == 0));
+}
@@ -0,0 +1,96 @@
+#include "bench.h"
+#include "bench_access.h"
+#include "bench_clients.h"
+#include "../replay.h"
+#include "../room_pool.h"
+
+#include <cstdio>
+#include <thread>
+
+namespace {
+constexpr uint32_t kPlayersPerRoom = 64;
+constexpr double kTickHz = 60.0;
+constexpr double kWarmupSeconds = 0.5;
+constexpr double kMeasureSeconds = 2.0;
+
+// Runs rooms of 64 human clients on the pool while this thread feeds every
+// room its inputs at 60 Hz, as the JS side would. Sustained means under 1% of
+// ticks started a full period late and the pool kept up with the tick rate.
+bool runRooms(uint32_t roomCount) {
+    using clock = std::chrono::steady_clock;
+    RoomPool pool;
+    std::vector<std::shared_ptr<GameServer>> rooms;
+    for (uint32_t r = 0; r < roomCount; ++r) {
+        rooms.push_back(pool.find(pool.create(GameConfig{kPlayersPerRoom, 40.0f, 0, {}}, kTickHz)));
+    }
+
+    const auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / kTickHz));
+    const uint32_t warmup = static_cast<uint32_t>(kWarmupSeconds * kTickHz);
+    const uint32_t measured = static_cast<uint32_t>(kMeasureSeconds * kTickHz);
+    auto next = clock::now();
+    for (uint32_t tick = 0; tick < warmup + measured; ++tick) {
+        if (tick == warmup) pool.resetStats();
+        for (auto &room : rooms) bench::pushClientInputs(*room, kPlayersPerRoom, tick);
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+    const RoomPool::Stats stats = pool.stats();
+
+    const double expected = static_cast<double>(roomCount) * measured;
+    const double lateRatio = stats.ticks ? static_cast<double>(stats.lateTicks) / stats.ticks : 1.0;
+    const bool sustained = stats.ticks >= expected * 0.99 && lateRatio < 0.01;
+    std::printf("  rooms=%-4u workers=%u ticks %6llu/%-6.0f late %5.2f%% mean start lag %8.1f us max %9.1f us %s\n",
+                roomCount, pool.workerCount(), static_cast<unsigned long long>(stats.ticks), expected,
+                lateRatio * 100.0, stats.ticks ? stats.totalLateNs / 1000.0 / stats.ticks : 0.0,
+                stats.maxLateNs / 1000.0, sustained ? "ok" : "OVERLOADED");
+    return sustained;
+}
+} // namespace
+
+// How many 64-player rooms this machine holds at 60 Hz: doubles the room count
+// until the pool falls behind, then bisects between the last two counts.
+BENCH_CASE(room_load) {
+    std::printf(" %u hardware threads\n", std::max(1u, std::thread::hardware_concurrency()));
+    uint32_t good = 0, bad = 0;
+    for (uint32_t rooms = 1; rooms <= 4096; rooms *= 2) {
+        if (!runRooms(rooms)) {
+            bad = rooms;
+            break;
+        }
+        good = rooms;
+    }
+    while (bad != 0 && bad - good > 1) {
+        const uint32_t mid = good + (bad - good) / 2;
+        if (runRooms(mid)) {
+            good = mid;
+        } else {
+            bad = mid;
+        }
+    }
+    std::printf("  sustained: %u rooms of %u players\n", good, kPlayersPerRoom);
+}
+
+// A destroyed room's input log must be complete on disk even while something
+// (a JS snapshot buffer) still holds the room.
+BENCH_CASE(room_destroy_flush) {
+    const char *path = "/tmp/burstfire_bench_room.bfil";
+    RoomPool pool(1);
+    GameConfig config{8, 40.0f, 0, {}};
+    config.recordPath = path;
+    const RoomPool::Handle handle = pool.create(config, kTickHz);
+    std::shared_ptr<GameServer> pinned = pool.find(handle);
+    for (uint32_t tick = 0; tick < 30; ++tick) {
+        bench::pushClientInputs(*pinned, 8, tick);
+        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+    }
+    pool.destroy(handle);
+    // A worker stepping it at the time stops it after that step.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const ReplayResult replayed = replayInputLog(path);
+    const uint32_t stepped = BenchAccess::tick(*pinned);
+    std::printf("  room still held: %u of %u ticks in its log, replay mismatches %u  %s\n", replayed.ticks, stepped,
+                replayed.mismatches,
+                bench::verdict(replayed.opened && replayed.ticks == stepped && replayed.mismatches == 0));
+    pinned.reset();
+    std::remove(path);
+}
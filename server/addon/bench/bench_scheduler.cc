@@ -0,0 +1,77 @@
+#include "bench.h"
+#include "../tick_profiler.h"
+#include "../tick_scheduler.h"
+
+namespace {
+constexpr double kTickHz = 60.0;
+
+TickClock::duration periodFor(double hz) {
+    return std::chrono::duration_cast<TickClock::duration>(std::chrono::duration<double>(1.0 / hz));
+}
+
+void busyFor(TickClock::duration d) {
+    const TickClock::time_point end = TickClock::now() + d;
+    while (TickClock::now() < end) {
+    }
+}
+
+// 60 Hz loop with 1 ms of work per tick; start lag = tick start - deadline.
+void measureJitter(TickWait wait) {
+    SchedulerConfig config;
+    config.wait = wait;
+    TickWaiter waiter(config);
+    TickSchedule schedule;
+    schedule.period = periodFor(kTickHz);
+    schedule.deadline = TickClock::now() + schedule.period;
+    LatencyHistogram lag;
+    for (int tick = 0; tick < 180; ++tick) {
+        waiter.waitUntil(schedule.deadline);
+        const TickClock::time_point start = TickClock::now();
+        lag.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(start - schedule.deadline).count()));
+        busyFor(std::chrono::milliseconds(1));
+        schedule.advance(config, TickClock::now());
+    }
+    std::printf("  %-8s start lag p50=%-8llu p99=%-8llu p999=%-8llu max=%llu (ns)\n", tickWaitName(wait),
+                static_cast<unsigned long long>(lag.percentile(0.5)), static_cast<unsigned long long>(lag.percentile(0.99)),
+                static_cast<unsigned long long>(lag.percentile(0.999)), static_cast<unsigned long long>(lag.max()));
+}
+
+// Simulated clock: 2 ms ticks with one 90 ms stall, over one second of
+// wall time. Shows how each policy spends the time after the stall.
+void simulateCatchUp(TickCatchUp catchUp) {
+    SchedulerConfig config;
+    config.catchUp = catchUp;
+    TickSchedule schedule;
+    schedule.period = periodFor(kTickHz);
+    const TickClock::time_point origin{};
+    schedule.deadline = origin + schedule.period;
+    const TickClock::time_point end = origin + std::chrono::seconds(1);
+    uint32_t ticks = 0, skipped = 0, run = 0, longestRun = 0;
+    TickClock::time_point now = origin;
+    while (schedule.deadline < end) {
+        now = std::max(now, schedule.deadline);
+        const bool backToBack = now > schedule.deadline;
+        run = backToBack ? run + 1 : 0;
+        longestRun = std::max(longestRun, run);
+        now += ticks == 10 ? std::chrono::milliseconds(90) : std::chrono::milliseconds(2);
+        ++ticks;
+        skipped += schedule.advance(config, now);
+    }
+    // Where the next tick falls relative to the original 60 Hz grid.
+    const double phase = static_cast<double>((schedule.deadline - origin).count() % schedule.period.count()) /
+                         static_cast<double>(std::chrono::duration_cast<TickClock::duration>(std::chrono::milliseconds(1)).count());
+    std::printf("  %-10s ticks %3u/60 skipped %2u longest back-to-back %2u grid offset %5.2f ms\n",
+                tickCatchUpName(catchUp), ticks, skipped, longestRun, phase);
+}
+} // namespace
+
+BENCH_CASE(tick_scheduler) {
+    measureJitter(TickWait::Sleep);
+    measureJitter(TickWait::Hybrid);
+    measureJitter(TickWait::TimerFd);
+    simulateCatchUp(TickCatchUp::Burst);
+    simulateCatchUp(TickCatchUp::BurstLimit);
+    simulateCatchUp(TickCatchUp::Drop);
+    simulateCatchUp(TickCatchUp::SlowMotion);
+}
@@ -0,0 +1,101 @@
+#include "bench.h"
+#include "../entity_store.h"
+
+#include <unordered_map>
+
+namespace {
+struct Lcg {
+    uint32_t state = 4242;
+    uint32_t next() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+};
+
+// Same bookkeeping as GameServer::addPlayer/removePlayer.
+void removeSlot(PlayerStore &store, SlotMap &slots, uint32_t slot) {
+    const uint32_t last = static_cast<uint32_t>(store.size()) - 1;
+    slots.erase(store.info[slot].id);
+    slots.release(slot);
+    slots.release(last);
+    store.removeSwap(slot);
+    if (slot != last) slots.assign(store.info[slot].id, slot);
+}
+
+// Random joins and leaves checked against std::unordered_map; handles taken
+// before a removal must stop resolving once their slot changes hands.
+void churn(uint32_t capacity) {
+    Lcg rng;
+    PlayerStore store;
+    SlotMap slots;
+    slots.reserve(capacity);
+    std::unordered_map<uint32_t, uint32_t> ref; // id -> slot
+    uint32_t nextId = 1;
+    uint64_t mismatches = 0, staleResolved = 0, handlesChecked = 0;
+    for (int op = 0; op < 200000; ++op) {
+        const bool join = store.size() == 0 || (store.size() < capacity && rng.next() % 2 == 0);
+        if (join) {
+            const uint32_t id = nextId++ * 7919u;
+            const uint32_t slot = store.add(id, false);
+            slots.assign(id, slot);
+            ref[id] = slot;
+        } else {
+            const uint32_t slot = rng.next() % store.size();
+            const uint32_t last = static_cast<uint32_t>(store.size()) - 1;
+            const PlayerHandle gone = slots.handle(slot);
+            const PlayerHandle moved = slots.handle(last);
+            ref.erase(store.info[slot].id);
+            if (slot != last) ref[store.info[last].id] = slot;
+            removeSlot(store, slots, slot);
+            staleResolved += slots.resolve(gone) != kNoSlot;
+            staleResolved += slot != last && slots.resolve(moved) != kNoSlot;
+            handlesChecked += 2;
+        }
+        if (op % 1000 == 0) {
+            for (const auto &kv : ref) mismatches += slots.find(kv.first) != kv.second;
+            for (uint32_t i = 0; i < store.size(); ++i) mismatches += slots.find(store.info[i].id) != i;
+            mismatches += slots.find(0xFFFFFFF0u) != kNoSlot;
+        }
+    }
+    std::printf("  churn cap=%-5u lookup mismatches %llu, stale handles resolved %llu/%llu\n", capacity,
+                static_cast<unsigned long long>(mismatches), static_cast<unsigned long long>(staleResolved),
+                static_cast<unsigned long long>(handlesChecked));
+    if (mismatches || staleResolved) bench::fail();
+}
+
+void lookup(uint32_t n) {
+    PlayerStore store;
+    SlotMap slots;
+    slots.reserve(n);
+    for (uint32_t i = 0; i < n; ++i) slots.assign(1000000 + i * 3, store.add(1000000 + i * 3, false));
+    Lcg rng;
+    std::vector<uint32_t> queries(4096);
+    for (uint32_t &q : queries) q = 1000000 + (rng.next() % n) * 3;
+
+    uint64_t linearSum = 0, mapSum = 0;
+    uint64_t t0 = bench::nowNs();
+    for (uint32_t q : queries) {
+        for (uint32_t i = 0; i < store.size(); ++i) {
+            if (store.info[i].id == q) {
+                linearSum += i;
+                break;
+            }
+        }
+    }
+    const double linearNs = static_cast<double>(bench::nowNs() - t0) / queries.size();
+    t0 = bench::nowNs();
+    for (uint32_t q : queries) mapSum += slots.find(q);
+    const double mapNs = static_cast<double>(bench::nowNs() - t0) / queries.size();
+    bench::doNotOptimize(mapSum);
+    std::printf("  n=%-5u find linear %8.1f ns slot map %5.1f ns (%s)\n", n, linearNs, mapNs,
+                bench::verdict(linearSum == mapSum));
+}
+} // namespace
+
+BENCH_CASE(slot_map) {
+    churn(64);
+    churn(2048);
+    lookup(64);
+    lookup(512);
+    lookup(2048);
+}
@@ -0,0 +1,127 @@
+#include "bench.h"
+#include "../snapshot_buffer.h"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace {
+constexpr size_t kFrameBytes = 4 + 2 + 64 * 51; // 64 players in the full snapshot layout
+constexpr int kReads = 200000;
+
+void fillFrame(std::vector<uint8_t> &data, uint32_t tick) {
+    data.resize(kFrameBytes);
+    std::memset(data.data(), static_cast<int>(tick & 0xff), data.size());
+    std::memcpy(data.data(), &tick, sizeof(tick));
+}
+
+// Previous scheme: the tick thread swaps under a mutex and every reader copies.
+struct MutexSnapshot {
+    std::mutex mutex;
+    std::vector<uint8_t> data;
+};
+} // namespace
+
+BENCH_CASE(snapshot_publication) {
+    std::vector<uint64_t> publishNs;
+    std::vector<uint64_t> readNs;
+    readNs.reserve(kReads);
+
+    {
+        SnapshotPublisher publisher;
+        std::atomic<bool> done{false};
+        std::thread writer([&] {
+            uint32_t tick = 0;
+            publishNs.reserve(1 << 20);
+            while (!done.load(std::memory_order_relaxed)) {
+                const uint64_t t0 = bench::nowNs();
+                SnapshotFrame *frame = publisher.beginFrame();
+                fillFrame(frame->data, ++tick);
+                frame->full = {0, 0, static_cast<uint32_t>(frame->data.size())};
+                frame->tick = tick;
+                publisher.publish(frame);
+                if (publishNs.size() < publishNs.capacity()) publishNs.push_back(bench::nowNs() - t0);
+            }
+        });
+        uint64_t sink = 0;
+        for (int i = 0; i < kReads; ++i) {
+            const uint64_t t0 = bench::nowNs();
+            SnapshotView view = publisher.acquire();
+            if (!view.empty()) sink += view.data()[0] + view.data()[view.size() - 1];
+            view.reset();
+            readNs.push_back(bench::nowNs() - t0);
+        }
+        bench::doNotOptimize(sink);
+        done.store(true);
+        writer.join();
+    }
+    std::printf(" refcounted publisher (writer publishing back-to-back)\n");
+    bench::printLatency("reader acquire+release", readNs);
+    bench::printLatency("writer build+publish", publishNs);
+
+    publishNs.clear();
+    readNs.clear();
+    {
+        MutexSnapshot shared;
+        std::atomic<bool> done{false};
+        std::thread writer([&] {
+            uint32_t tick = 0;
+            std::vector<uint8_t> data;
+            while (!done.load(std::memory_order_relaxed)) {
+                const uint64_t t0 = bench::nowNs();
+                fillFrame(data, ++tick);
+                {
+                    std::lock_guard<std::mutex> lock(shared.mutex);
+                    shared.data.swap(data);
+                }
+                if (publishNs.size() < publishNs.capacity()) publishNs.push_back(bench::nowNs() - t0);
+            }
+        });
+        uint64_t sink = 0;
+        std::vector<uint8_t> copy;
+        for (int i = 0; i < kReads; ++i) {
+            const uint64_t t0 = bench::nowNs();
+            {
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                copy = shared.data;
+            }
+            if (!copy.empty()) sink += copy[0] + copy[copy.size() - 1];
+            readNs.push_back(bench::nowNs() - t0);
+        }
+        bench::doNotOptimize(sink);
+        done.store(true);
+        writer.join();
+    }
+    std::printf(" mutex + copy baseline\n");
+    bench::printLatency("reader lock+copy", readNs);
+    bench::printLatency("writer build+swap", publishNs);
+}
+
+// Readers pinning every frame for a burst of ticks (JS buffers awaiting GC)
+// grow the pool; once they let go, the pool gives the extra buffers back.
+BENCH_CASE(snapshot_pool_trim) {
+    constexpr int kPinnedTicks = 64;
+    SnapshotPublisher publisher;
+    auto publishTick = [&publisher](uint32_t tick) {
+        SnapshotFrame *frame = publisher.beginFrame();
+        fillFrame(frame->data, tick);
+        frame->full = {0, 0, static_cast<uint32_t>(frame->data.size())};
+        frame->tick = tick;
+        publisher.publish(frame);
+    };
+    uint32_t tick = 0;
+    std::vector<SnapshotFrame *> pinned;
+    for (int i = 0; i < kPinnedTicks; ++i) {
+        publishTick(++tick);
+        pinned.push_back(publisher.acquire().detach());
+    }
+    const size_t peak = publisher.retainedBytes();
+    for (SnapshotFrame *frame : pinned) SnapshotPublisher::release(frame);
+    // A grown pool is trimmed every 64 frames, back to 4 with buffers.
+    for (int i = 0; i < 128; ++i) publishTick(++tick);
+    const size_t after = publisher.retainedBytes();
+    const bool trimmed = after <= 4 * kFrameBytes;
+    std::printf("  %d ticks pinned: %zu B held; released: %zu B held  %s\n", kPinnedTicks, peak, after,
+                bench::verdict(trimmed));
+}
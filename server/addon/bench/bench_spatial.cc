@@ -0,0 +1,123 @@
+#include "bench.h"
+#include "../spatial_grid.h"
+
+#include <cmath>
+
+namespace {
+constexpr float kHalfExtent = 50.0f;
+constexpr float kCellSize = 4.0f;
+constexpr float kHitRadius = 0.6f;
+constexpr float kRange = 22.0f;
+constexpr int kPellets = 8;
+
+struct Lcg {
+    uint32_t state = 777;
+    float next() {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8) / static_cast<float>(1u << 24);
+    }
+};
+
+struct Point {
+    float x, y, z;
+};
+
+bool hitsSphere(const Point &o, float dx, float dy, float dz, const Point &c) {
+    const float lx = c.x - o.x, ly = c.y - o.y, lz = c.z - o.z;
+    const float tca = lx * dx + ly * dy + lz * dz;
+    if (tca < 0.0f) return false;
+    const float d2 = lx * lx + ly * ly + lz * lz - tca * tca;
+    if (d2 > kHitRadius * kHitRadius) return false;
+    return tca - std::sqrt(kHitRadius * kHitRadius - d2) <= kRange;
+}
+
+void runSize(uint32_t n) {
+    Lcg rng;
+    std::vector<Point> pts(n);
+    for (auto &p : pts) p = {rng.next() * 2.0f * kHalfExtent - kHalfExtent, 1.2f, rng.next() * 2.0f * kHalfExtent - kHalfExtent};
+
+    SpatialGrid grid;
+    grid.reset(kHalfExtent, kCellSize);
+    uint64_t t0 = bench::nowNs();
+    for (uint32_t i = 0; i < n; ++i) grid.insert(i, pts[i].x, pts[i].z);
+    const double buildUs = static_cast<double>(bench::nowNs() - t0) / 1000.0;
+
+    // Nearest other entity for every entity (bot targeting), unbounded radius.
+    uint64_t bruteSum = 0, gridSum = 0;
+    t0 = bench::nowNs();
+    for (uint32_t q = 0; q < n; ++q) {
+        uint32_t best = SpatialGrid::kNone;
+        float bestD2 = 1e30f;
+        for (uint32_t i = 0; i < n; ++i) {
+            if (i == q) continue;
+            const float dx = pts[i].x - pts[q].x, dz = pts[i].z - pts[q].z;
+            const float d2 = dx * dx + dz * dz;
+            if (d2 < bestD2) {
+                bestD2 = d2;
+                best = i;
+            }
+        }
+        bruteSum += best;
+    }
+    const double bruteNearestNs = static_cast<double>(bench::nowNs() - t0) / n;
+    t0 = bench::nowNs();
+    for (uint32_t q = 0; q < n; ++q) {
+        float d2 = 0.0f;
+        gridSum += grid.nearest(pts[q].x, pts[q].z, kHalfExtent * 3.0f, [q](uint32_t i) { return i != q; }, d2);
+    }
+    const double gridNearestNs = static_cast<double>(bench::nowNs() - t0) / n;
+
+    // One shotgun volley per entity: 8 pellets tested against everyone else.
+    std::vector<float> dirs;
+    for (uint32_t s = 0; s < n; ++s) {
+        for (int p = 0; p < kPellets; ++p) {
+            const float yaw = rng.next() * 6.2831853f;
+            const float pitch = rng.next() * 0.2f - 0.1f;
+            dirs.push_back(-std::sin(yaw) * std::cos(pitch));
+            dirs.push_back(std::sin(pitch));
+            dirs.push_back(-std::cos(yaw) * std::cos(pitch));
+        }
+    }
+    uint64_t bruteHits = 0, gridHits = 0;
+    t0 = bench::nowNs();
+    for (uint32_t s = 0; s < n; ++s) {
+        for (int p = 0; p < kPellets; ++p) {
+            const float *d = &dirs[(s * kPellets + p) * 3];
+            for (uint32_t i = 0; i < n; ++i) {
+                if (i != s && hitsSphere(pts[s], d[0], d[1], d[2], pts[i])) ++bruteHits;
+            }
+        }
+    }
+    const double bruteRayNs = static_cast<double>(bench::nowNs() - t0) / n;
+    t0 = bench::nowNs();
+    for (uint32_t s = 0; s < n; ++s) {
+        for (int p = 0; p < kPellets; ++p) {
+            const float *d = &dirs[(s * kPellets + p) * 3];
+            grid.traceRay(pts[s].x, pts[s].z, d[0], d[2], kRange, kHitRadius, [&](uint32_t i, float) {
+                if (i != s && hitsSphere(pts[s], d[0], d[1], d[2], pts[i])) ++gridHits;
+                return true;
+            });
+        }
+    }
+    const double gridRayNs = static_cast<double>(bench::nowNs() - t0) / n;
+
+    // Radius query (e.g. interest management) of 20 units around every entity.
+    uint64_t radiusFound = 0;
+    t0 = bench::nowNs();
+    for (uint32_t q = 0; q < n; ++q) grid.queryRadius(pts[q].x, pts[q].z, 20.0f, [&](uint32_t) { ++radiusFound; });
+    const double radiusNs = static_cast<double>(bench::nowNs() - t0) / n;
+
+    bench::doNotOptimize(radiusFound);
+    std::printf("  n=%-5u build %7.1f us | nearest brute %8.0f ns grid %6.0f ns (%s) | volley brute %9.0f ns grid %7.0f ns (hits %llu/%llu) | radius20 %6.0f ns\n",
+                n, buildUs, bruteNearestNs, gridNearestNs, bench::verdict(bruteSum == gridSum), bruteRayNs,
+                gridRayNs, static_cast<unsigned long long>(gridHits), static_cast<unsigned long long>(bruteHits),
+                radiusNs);
+}
+} // namespace
+
+BENCH_CASE(spatial_grid) {
+    std::printf(" per-query cost; volley = 8 pellets from one shooter\n");
+    runSize(64);
+    runSize(256);
+    runSize(1024);
+}
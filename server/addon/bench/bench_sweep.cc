@@ -0,0 +1,103 @@
+#include "bench.h"
+#include "bench_access.h"
+
+#include <cmath>
+#include <limits>
+#include <memory>
+
+namespace {
+constexpr uint32_t kPlayers = 512;
+constexpr uint32_t kRows = 15;
+constexpr float kWallWidth = 0.02f;
+constexpr float kPlayerRadius = 0.35f;
+constexpr float kSpeed = 12.0f; // kMaxSpeed
+constexpr int kReps = 200;
+
+float rowZ(uint32_t row) { return -30.0f + 4.0f * static_cast<float>(row); }
+
+// Rows of 2 cm walls across the map and every player just in front of one,
+// running at it at full speed, straight or at 45 degrees.
+struct Approach {
+    PlayerStore start;
+    std::vector<float> fromX, fromZ;
+};
+
+Approach approach(GameServer &server, float dt) {
+    std::vector<Wall> &walls = BenchAccess::walls(server);
+    walls.resize(4);
+    for (uint32_t row = 0; row < kRows; ++row) walls.push_back({-38.0f, 38.0f, rowZ(row), rowZ(row) + kWallWidth});
+    BenchAccess::buildColliders(server);
+    PlayerStore &p = BenchAccess::players(server);
+    Approach a;
+    uint32_t state = 7;
+    for (uint32_t i = 0; i < p.size(); ++i) {
+        const float x = benchRandom(state) * 60.0f - 30.0f;
+        const float z = rowZ(i % kRows) + kWallWidth + kPlayerRadius + 0.01f + benchRandom(state) * 0.2f;
+        const bool diagonal = i % 2 == 1;
+        p.vx[i] = diagonal ? kSpeed * 0.70710678f : 0.0f;
+        p.vz[i] = diagonal ? -kSpeed * 0.70710678f : -kSpeed;
+        a.fromX.push_back(x);
+        a.fromZ.push_back(z);
+        p.x[i] = x + p.vx[i] * dt;
+        p.z[i] = z + p.vz[i] * dt;
+    }
+    a.start = p;
+    return a;
+}
+
+struct Outcome {
+    uint32_t crossed = 0; // ended past their wall
+    uint32_t stopped = 0; // stopped at it, keeping the motion along it
+    double ns = 0.0;      // per player
+};
+
+Outcome run(GameServer &server, const Approach &a) {
+    PlayerStore &p = BenchAccess::players(server);
+    Outcome o;
+    const uint64_t t0 = bench::nowNs();
+    for (int r = 0; r < kReps; ++r) {
+        p = a.start;
+        BenchAccess::resolveWalls(server, a.fromX, a.fromZ);
+    }
+    o.ns = static_cast<double>(bench::nowNs() - t0) / kReps / kPlayers;
+    for (uint32_t i = 0; i < p.size(); ++i) {
+        const float wallZ = rowZ(i % kRows);
+        if (p.z[i] < wallZ) ++o.crossed;
+        const bool atWall = p.z[i] == wallZ + kWallWidth + kPlayerRadius && p.vz[i] == 0.0f;
+        const bool kept = std::fabs(p.x[i] - a.start.x[i]) < 1e-4f && p.vx[i] == a.start.vx[i];
+        if (atWall && kept) ++o.stopped;
+    }
+    return o;
+}
+
+void runSweep(uint32_t hz) {
+    auto server = std::make_unique<GameServer>();
+    BenchAccess::populate(*server, kPlayers);
+    const float dt = 1.0f / static_cast<float>(hz);
+    const Approach a = approach(*server, dt);
+    // Players whose move this tick reaches their wall.
+    uint32_t reaching = 0;
+    for (uint32_t i = 0; i < kPlayers; ++i) reaching += a.start.z[i] < rowZ(i % kRows) + kWallWidth + kPlayerRadius;
+
+    BenchAccess::setSweepFrom(*server, std::numeric_limits<float>::infinity());
+    const Outcome discrete = run(*server, a);
+    BenchAccess::buildColliders(*server);
+    const Outcome swept = run(*server, a);
+    BenchAccess::setSweepFrom(*server, -std::numeric_limits<float>::infinity());
+    const Outcome always = run(*server, a);
+    std::printf("  %2u Hz, %u of %u reach a 2 cm wall: push-out only %3u through (%5.1f ns/player), swept %u through, "
+                "%3u stopped and sliding (%5.1f ns/player, %5.1f sweeping every move)  %s\n",
+                hz, reaching, kPlayers, discrete.crossed, discrete.ns, swept.crossed, swept.stopped, swept.ns, always.ns,
+                bench::verdict(swept.crossed == 0 && swept.stopped == reaching));
+}
+} // namespace
+
+// Players running at full speed into thin walls, resolved by push-out alone
+// and with swept collision (which only engages on moves long enough to cross
+// a wall). Swept, none may pass and every one that reaches its wall must end
+// against it with its motion along the wall intact.
+BENCH_CASE(swept_collision) {
+    runSweep(60);
+    runSweep(30);
+    runSweep(20);
+}
@@ -0,0 +1,53 @@
+#include "bench.h"
+#include "bench_access.h"
+#include "bench_clients.h"
+
+#include <cmath>
+#include <memory>
+
+namespace {
+constexpr float kDt = 1.0f / 60.0f;
+constexpr uint32_t kWarmupTicks = 60;
+
+void runTicks(uint32_t clients, uint32_t bots) {
+    auto server = std::make_unique<GameServer>();
+    GameConfig config{clients + bots, 40.0f, bots, {}};
+    config.inputRate.rate = 0.0f; // faster than real time
+    server->startHeadless(config);
+    const uint32_t measured = std::max(60u, 300u * 64u / (clients + bots));
+    std::vector<uint64_t> samples;
+    samples.reserve(measured);
+    for (uint32_t tick = 0; tick < kWarmupTicks + measured; ++tick) {
+        bench::pushClientInputs(*server, clients, tick);
+        const uint64_t t0 = bench::nowNs();
+        server->step(kDt);
+        if (tick >= kWarmupTicks) samples.push_back(bench::nowNs() - t0);
+    }
+    char label[64];
+    std::snprintf(label, sizeof(label), "%u clients + %u bots", clients, bots);
+    bench::printLatency(label, samples);
+}
+} // namespace
+
+// Whole-tick cost (input drain, bots, idle integration, snapshots) by entity
+// count. Mostly-client rooms are dominated by per-client snapshot encoding;
+// mostly-bot rooms by simulation.
+BENCH_CASE(tick_scaling) {
+    const uint32_t sizes[] = {64, 512, 2048};
+    for (uint32_t n : sizes) runTicks(n * 3 / 4, n / 4);
+    for (uint32_t n : sizes) runTicks(8, n - 8);
+}
+
+// Rooms of human clients only, where every client sends input most ticks.
+BENCH_CASE(tick_clients) {
+    const uint32_t sizes[] = {64, 128, 256, 512};
+    for (uint32_t n : sizes) runTicks(n, 0);
+}
+
+// Idle movement + wall/platform resolution for every player: the per-player
+// integratePlayer path vs the batched SoA pass. Both must produce identical state.
+BENCH_CASE(movement_pass) {
+    BenchAccess::runMovement(64);
+    BenchAccess::runMovement(512);
+    BenchAccess::runMovement(2048);
+}
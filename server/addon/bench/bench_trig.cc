@@ -0,0 +1,207 @@
+#include "bench.h"
+#include "bench_access.h"
+#include "../game_math.h"
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+constexpr double kSinCosBound = 1.2e-7;
+constexpr double kAtan2Bound = 3.0e-7;
+constexpr size_t kBatch = 1024;
+
+bool sameBits(float a, float b) { return std::memcmp(&a, &b, sizeof(a)) == 0; }
+
+float nextFloat(float x, uint32_t ulps) {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    bits += ulps;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+struct SinCosCheck {
+    std::vector<float> x;
+    uint64_t args = 0, scalarDiffers = 0;
+    double worst = 0.0;
+    float worstAt = 0.0f;
+
+    // Runs the pending arguments through the batched and scalar forms.
+    void flush() {
+        std::vector<float> s(x.size()), c(x.size());
+        fastSinCos(x.data(), s.data(), c.data(), x.size());
+        for (size_t i = 0; i < x.size(); ++i) {
+            float ss, cs;
+            fastSinCos(x[i], ss, cs);
+            scalarDiffers += !sameBits(ss, s[i]) || !sameBits(cs, c[i]);
+            if (!std::isfinite(x[i])) continue;
+            const double err = std::max(std::fabs(s[i] - std::sin(static_cast<double>(x[i]))),
+                                        std::fabs(c[i] - std::cos(static_cast<double>(x[i]))));
+            if (err > worst) {
+                worst = err;
+                worstAt = x[i];
+            }
+        }
+        args += x.size();
+        x.clear();
+    }
+    void add(float v) {
+        x.push_back(v);
+        x.push_back(-v);
+        if (x.size() >= 8192) flush();
+    }
+};
+
+// Every 127th float up to kFastTrigRange and every float within 4096 ulps
+// of the first few multiples of pi/4, where the reduction switches
+// polynomial, both signs; then a few past the range and non-finite.
+void checkSinCos() {
+    SinCosCheck check;
+    for (float x = 1e-30f; x <= kFastTrigRange; x = nextFloat(x, 127)) check.add(x);
+    for (int k = 1; k <= 64; ++k) {
+        const float at = static_cast<float>(k * M_PI / 4.0);
+        for (float x = nextFloat(at, -4096u); x != nextFloat(at, 4096); x = nextFloat(x, 1)) check.add(x);
+    }
+    for (float x : {0.0f, 9000.0f, 1e6f, INFINITY, NAN}) check.add(x);
+    check.flush();
+    std::printf("  sincos  %9llu args  max error %.3g at %.9g (bound %.2g)  batched = scalar: %s  %s\n",
+                static_cast<unsigned long long>(check.args), check.worst, check.worstAt, kSinCosBound,
+                check.scalarDiffers ? "no" : "yes",
+                bench::verdict(check.worst <= kSinCosBound && check.scalarDiffers == 0));
+}
+
+void checkAtan2() {
+    // Directions all round the circle at several lengths, the axes and the origin.
+    std::vector<float> ys, xs;
+    for (uint32_t k = 0; k < 1u << 20; ++k) {
+        const double angle = (static_cast<double>(k) / (1u << 20) - 0.5) * 2.0 * M_PI;
+        const double len = std::ldexp(1.0, static_cast<int>(k % 41) - 20);
+        ys.push_back(static_cast<float>(std::sin(angle) * len));
+        xs.push_back(static_cast<float>(std::cos(angle) * len));
+    }
+    for (float a : {0.0f, 1.0f, -1.0f, 3e-5f}) {
+        for (float b : {0.0f, 1.0f, -1.0f, 3e-5f}) {
+            ys.push_back(a);
+            xs.push_back(b);
+        }
+    }
+    std::vector<float> out(ys.size());
+    fastAtan2(ys.data(), xs.data(), out.data(), ys.size());
+    double worst = 0.0;
+    uint64_t scalarDiffers = 0;
+    for (size_t i = 0; i < ys.size(); ++i) {
+        scalarDiffers += !sameBits(fastAtan2(ys[i], xs[i]), out[i]);
+        const double ref = ys[i] == 0.0f && xs[i] == 0.0f ? 0.0 : std::atan2(ys[i], static_cast<double>(xs[i]));
+        // +-pi are the same heading.
+        double err = std::fabs(out[i] - ref);
+        err = std::min(err, std::fabs(err - 2.0 * M_PI));
+        worst = std::max(worst, err);
+    }
+    std::printf("  atan2   %9zu args  max error %.3g (bound %.2g)  batched = scalar: %s  %s\n", ys.size(), worst,
+                kAtan2Bound, scalarDiffers ? "no" : "yes",
+                bench::verdict(worst <= kAtan2Bound && scalarDiffers == 0));
+}
+
+template <typename Op>
+double nsPerCall(Op op) {
+    constexpr int kReps = 2000;
+    const uint64_t t0 = bench::nowNs();
+    for (int r = 0; r < kReps; ++r) op();
+    return static_cast<double>(bench::nowNs() - t0) / kReps / kBatch;
+}
+
+void timeTrig() {
+    std::vector<float> x(kBatch), y(kBatch), s(kBatch), c(kBatch);
+    uint32_t state = 3;
+    for (size_t i = 0; i < kBatch; ++i) {
+        x[i] = (benchRandom(state) * 2.0f - 1.0f) * 20.0f;
+        y[i] = benchRandom(state) * 2.0f - 1.0f;
+    }
+    const double libSinCos = nsPerCall([&] {
+        for (size_t i = 0; i < kBatch; ++i) {
+            s[i] = std::sin(x[i]);
+            c[i] = std::cos(x[i]);
+            bench::doNotOptimize(s[i]);
+        }
+    });
+    const double scalarSinCos = nsPerCall([&] {
+        for (size_t i = 0; i < kBatch; ++i) {
+            fastSinCos(x[i], s[i], c[i]);
+            bench::doNotOptimize(s[i]); // one call at a time, as integratePlayer makes them
+        }
+    });
+    const double batchSinCos = nsPerCall([&] {
+        fastSinCos(x.data(), s.data(), c.data(), kBatch);
+        bench::doNotOptimize(s[0]);
+    });
+    const double libAtan2 = nsPerCall([&] {
+        for (size_t i = 0; i < kBatch; ++i) {
+            s[i] = std::atan2(y[i], x[i]);
+            bench::doNotOptimize(s[i]);
+        }
+    });
+    const double scalarAtan2 = nsPerCall([&] {
+        for (size_t i = 0; i < kBatch; ++i) {
+            s[i] = fastAtan2(y[i], x[i]);
+            bench::doNotOptimize(s[i]);
+        }
+    });
+    const double batchAtan2 = nsPerCall([&] {
+        fastAtan2(y.data(), x.data(), s.data(), kBatch);
+        bench::doNotOptimize(s[0]);
+    });
+    std::printf("  sincos  libm %5.2f ns  fast %5.2f ns  batched %5.2f ns\n", libSinCos, scalarSinCos, batchSinCos);
+    std::printf("  atan2   libm %5.2f ns  fast %5.2f ns  batched %5.2f ns\n", libAtan2, scalarAtan2, batchAtan2);
+}
+
+// The client predictor (predict.ts) runs the same movement in doubles with
+// Math.sin / Math.cos; a second of turning, strafing input must land within
+// a millimetre of the server's.
+void checkPrediction() {
+    auto server = std::make_unique<GameServer>();
+    BenchAccess::populate(*server, 64);
+    PlayerStore &p = BenchAccess::players(*server);
+    double worst = 0.0;
+    uint32_t state = 11;
+    for (uint32_t slot = 0; slot < p.size(); ++slot) {
+        BenchAccess::place(*server, slot, 0.0f, 0.0f);
+        p.vx[slot] = p.vz[slot] = 0.0f;
+        double x = p.x[slot], z = p.z[slot], vx = 0.0, vz = 0.0;
+        float yaw = (benchRandom(state) * 2.0f - 1.0f) * 400.0f; // yaw is never wrapped
+        for (int tick = 0; tick < 60; ++tick) {
+            InputPacket in{};
+            in.yaw = yaw += 0.05f;
+            in.moveX = tick % 20 < 10 ? 1.0f : -1.0f;
+            in.moveZ = 1.0f;
+            BenchAccess::integratePlayer(*server, slot, in);
+            const double fx = -std::sin(static_cast<double>(in.yaw)), fz = -std::cos(static_cast<double>(in.yaw));
+            double mx = fx * in.moveZ - fz * in.moveX, mz = fz * in.moveZ + fx * in.moveX;
+            const double len = std::hypot(mx, mz);
+            mx /= len;
+            mz /= len;
+            vx += mx * 50.0 * kBenchDt;
+            vz += mz * 50.0 * kBenchDt;
+            const double speed = std::hypot(vx, vz);
+            const double scale = std::max(0.0, speed - speed * 8.0 * kBenchDt) / speed;
+            vx *= scale;
+            vz *= scale;
+            x += vx * kBenchDt;
+            z += vz * kBenchDt;
+        }
+        worst = std::max(worst, std::hypot(p.x[slot] - x, p.z[slot] - z));
+    }
+    std::printf("  predict.ts drift after 60 ticks  max %.3g m  %s\n", worst, bench::verdict(worst < 1e-3));
+}
+} // namespace
+
+// Accuracy of the fast trig in game_math.h against double libm over its
+// whole range, batched vs scalar bit equality, speed, and how far the
+// server's movement drifts from the client predictor's.
+BENCH_CASE(trig_accuracy) {
+    checkSinCos();
+    checkAtan2();
+    checkPrediction();
+    timeTrig();
+}
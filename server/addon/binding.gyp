@@ -1,25 +1,102 @@
 {
+  "variables": {
+    # 1 also builds the bench and headless executables (npm run build:tools).
+    "build_tools%": 0,
+    "core_sources": [
+      "collider_grid.cc",
+      "entity_store.cc",
+      "game_server.cc",
+      "game_server_ai.cc",
+      "game_server_players.cc",
+      "game_server_world.cc",
+      "interest_sets.cc",
+      "input_lanes.cc",
+      "input_log.cc",
+      "input_queue.cc",
+      "map_file.cc",
+      "pellet_kernel.cc",
+      "position_history.cc",
+      "replay.cc",
+      "room_pool.cc",
+      "snapshot_buffer.cc",
+      "snapshot_codec.cc",
+      "spatial_grid.cc",
+      "tick_profiler.cc",
+      "tick_scheduler.cc"
+    ]
+  },
+  "target_defaults": {
+    "cflags_cc": ["-std=c++17", "-fno-math-errno"],
+    # node's common.gypi turns exceptions off; the core and bench throw.
+    "cflags_cc!": ["-fno-exceptions"],
+    "xcode_settings": {
+      "GCC_ENABLE_CPP_EXCEPTIONS": "YES"
+    },
+    "msvs_settings": {
+      "VCCLCompilerTool": {
+        "ExceptionHandling": 1
+      }
+    }
+  },
   "targets": [
     {
       "target_name": "addon",
       "sources": [
         "addon.cc",
-        "game_server.cc",
-        "game_server_ai.cc",
-        "game_server_players.cc",
-        "game_server_world.cc"
+        "<@(core_sources)"
       ],
       "include_dirs": [
         "<(module_root_dir)/../node_modules/node-addon-api"
       ],
-      "msvs_settings": {
-        "VCCLCompilerTool": {
-          "ExceptionHandling": 1
-        }
-      },
-      "cflags_cc": ["-std=c++17"],
       "defines": ["NAPI_CPP_EXCEPTIONS"],
       "dependencies": ["<!(node -p \"require('node-addon-api').gyp\")"]
     }
+  ],
+  "conditions": [
+    ["build_tools==1", {
+      "targets": [
+        {
+          "target_name": "bench",
+          "type": "executable",
+          "sources": [
+            "bench/bench_main.cc",
+            "bench/bench_colliders.cc",
+            "bench/bench_delta.cc",
+            "bench/bench_hotpaths.cc",
+            "bench/bench_input.cc",
+            "bench/bench_interest.cc",
+            "bench/bench_lagcomp.cc",
+            "bench/bench_map.cc",
+            "bench/bench_occlusion.cc",
+            "bench/bench_pellets.cc",
+            "bench/bench_profiler.cc",
+            "bench/bench_replay.cc",
+            "bench/bench_rooms.cc",
+            "bench/bench_scheduler.cc",
+            "bench/bench_slots.cc",
+            "bench/bench_snapshot.cc",
+            "bench/bench_spatial.cc",
+            "bench/bench_sweep.cc",
+            "bench/bench_trig.cc",
+            "bench/bench_tick.cc",
+            "<@(core_sources)"
+          ],
+          "conditions": [
+            ["OS!='win'", { "libraries": ["-lpthread"] }]
+          ]
+        },
+        {
+          "target_name": "headless",
+          "type": "executable",
+          "sources": [
+            "headless/headless_main.cc",
+            "<@(core_sources)"
+          ],
+          "conditions": [
+            ["OS!='win'", { "libraries": ["-lpthread"] }]
+          ]
+        }
+      ]
+    }]
   ]
 }
@@ -0,0 +1,92 @@
+#ifndef BIT_STREAM_H
+#define BIT_STREAM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// LSB-first bit packing, appended to a byte vector.
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t> &out) : out_(out) {}
+
+    void write(uint32_t value, unsigned bits) {
+        if (bits < 32) value &= (1u << bits) - 1u;
+        acc_ |= static_cast<uint64_t>(value) << count_;
+        count_ += bits;
+        while (count_ >= 8) {
+            out_.push_back(static_cast<uint8_t>(acc_));
+            acc_ >>= 8;
+            count_ -= 8;
+        }
+    }
+
+    void writeBool(bool value) { write(value ? 1u : 0u, 1); }
+
+    // 6-bit length prefix then the significant bits; small values stay small.
+    void writeVar(uint32_t value) {
+        unsigned bits = 0;
+        while (bits < 32 && (value >> bits) != 0) ++bits;
+        write(bits, 6);
+        if (bits) write(value, bits);
+    }
+
+    // Pads the final partial byte with zeros.
+    void flush() {
+        if (count_ > 0) out_.push_back(static_cast<uint8_t>(acc_));
+        acc_ = 0;
+        count_ = 0;
+    }
+
+private:
+    std::vector<uint8_t> &out_;
+    uint64_t acc_ = 0;
+    unsigned count_ = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+
+    // Reads past the end yield zeros and set overflowed().
+    uint32_t read(unsigned bits) {
+        uint64_t value = 0;
+        unsigned got = 0;
+        while (got < bits) {
+            const size_t byte = pos_ >> 3;
+            if (byte >= size_) {
+                overflow_ = true;
+                return 0;
+            }
+            const unsigned offset = static_cast<unsigned>(pos_ & 7);
+            const unsigned take = std::min(bits - got, 8u - offset);
+            const uint64_t chunk = (data_[byte] >> offset) & ((1u << take) - 1u);
+            value |= chunk << got;
+            got += take;
+            pos_ += take;
+        }
+        return static_cast<uint32_t>(value);
+    }
+
+    bool readBool() { return read(1) != 0; }
+
+    uint32_t readVar() {
+        const unsigned bits = read(6);
+        if (bits > 32) {
+            overflow_ = true;
+            return 0;
+        }
+        return bits ? read(bits) : 0;
+    }
+
+    bool overflowed() const { return overflow_; }
+
+private:
+    const uint8_t *data_;
+    size_t size_;
+    size_t pos_ = 0;
+    bool overflow_ = false;
+};
+
+#endif
@@ -0,0 +1,68 @@
+#include "collider_grid.h"
+
+void ColliderGrid::clear() {
+    ownBoxes_.clear();
+    ownCellStart_.clear();
+    ownItems_.clear();
+    boxes_ = nullptr;
+    cellStart_ = items_ = nullptr;
+    count_ = 0;
+    dim_ = 0;
+}
+
+void ColliderGrid::attach(const float *boxes, uint32_t stride, uint32_t count, float halfExtent, float cellSize,
+                          const uint32_t *cellStart, const uint32_t *items) {
+    clear();
+    if (count == 0) return;
+    boxes_ = boxes;
+    stride_ = stride;
+    count_ = count;
+    half_ = halfExtent;
+    invCell_ = 1.0f / cellSize;
+    dim_ = cellsPerSide(halfExtent, cellSize);
+    cellStart_ = cellStart;
+    items_ = items;
+}
+
+void ColliderGrid::rebuild(float halfExtent, float cellSize) {
+    ownCellStart_.clear();
+    ownItems_.clear();
+    boxes_ = ownBoxes_.empty() ? nullptr : &ownBoxes_[0].minX;
+    stride_ = sizeof(Box) / sizeof(float);
+    count_ = static_cast<uint32_t>(ownBoxes_.size());
+    cellStart_ = items_ = nullptr;
+    dim_ = 0;
+    if (ownBoxes_.empty()) return;
+    half_ = halfExtent;
+    invCell_ = 1.0f / cellSize;
+    dim_ = cellsPerSide(halfExtent, cellSize);
+    const size_t cells = static_cast<size_t>(dim_) * static_cast<size_t>(dim_);
+
+    // Count, prefix-sum, fill. Colliders past the border land in edge cells.
+    ownCellStart_.assign(cells + 1, 0);
+    for (const Box &b : ownBoxes_) {
+        for (int cz = cellCoord(b.minZ); cz <= cellCoord(b.maxZ); ++cz) {
+            for (int cx = cellCoord(b.minX); cx <= cellCoord(b.maxX); ++cx) ++ownCellStart_[cz * dim_ + cx + 1];
+        }
+    }
+    for (size_t c = 0; c < cells; ++c) ownCellStart_[c + 1] += ownCellStart_[c];
+    ownItems_.resize(ownCellStart_[cells]);
+    std::vector<uint32_t> fill(ownCellStart_.begin(), ownCellStart_.end() - 1);
+    for (uint32_t i = 0; i < ownBoxes_.size(); ++i) {
+        const Box &b = ownBoxes_[i];
+        for (int cz = cellCoord(b.minZ); cz <= cellCoord(b.maxZ); ++cz) {
+            for (int cx = cellCoord(b.minX); cx <= cellCoord(b.maxX); ++cx) ownItems_[fill[cz * dim_ + cx]++] = i;
+        }
+    }
+    cellStart_ = ownCellStart_.data();
+    items_ = ownItems_.data();
+}
+
+void ColliderGrid::query(float minX, float maxX, float minZ, float maxZ, std::vector<uint32_t> &out) const {
+    out.clear();
+    forEach(minX, maxX, minZ, maxZ, [&out](uint32_t i) {
+        out.push_back(i);
+        return true;
+    });
+    std::sort(out.begin(), out.end());
+}
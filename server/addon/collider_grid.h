@@ -0,0 +1,151 @@
+#ifndef COLLIDER_GRID_H
+#define COLLIDER_GRID_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Region queried around a circle of radius r. An entity still contained in
+// it can only overlap colliders the query returned.
+struct ColliderBounds {
+    float minX, maxX, minZ, maxZ;
+    float r;
+
+    bool contains(float x, float z) const { return x - r >= minX && x + r <= maxX && z - r >= minZ && z + r <= maxZ; }
+};
+
+// Static axis-aligned rectangles on the XZ plane (walls, platform
+// footprints), bucketed into a uniform grid once per map. Each cell lists the
+// rectangles overlapping it in one flat array, so a query only reads the
+// cells under its box. Indices are positions in the vector built from.
+class ColliderGrid {
+public:
+    ColliderGrid() = default;
+    ColliderGrid(const ColliderGrid &) = delete; // may point into its own storage
+    ColliderGrid &operator=(const ColliderGrid &) = delete;
+
+    template <typename T>
+    void build(const std::vector<T> &colliders, float halfExtent, float cellSize) {
+        ownBoxes_.clear();
+        ownBoxes_.reserve(colliders.size());
+        for (const T &c : colliders) ownBoxes_.push_back({c.minX, c.maxX, c.minZ, c.maxZ});
+        rebuild(halfExtent, cellSize);
+    }
+    // Uses cell lists baked ahead of time (a map file) in place, without
+    // copying. boxes holds count colliders stride floats apart, each starting
+    // minX, maxX, minZ, maxZ; cellStart has dim * dim + 1 offsets into items.
+    // All of it must outlive the grid.
+    void attach(const float *boxes, uint32_t stride, uint32_t count, float halfExtent, float cellSize,
+                const uint32_t *cellStart, const uint32_t *items);
+    void clear();
+    bool empty() const { return count_ == 0; }
+    size_t size() const { return count_; }
+
+    // Cells per side for a map, as build() and baked grids lay them out.
+    static int cellsPerSide(float halfExtent, float cellSize) {
+        return std::max(1, static_cast<int>(std::ceil(2.0f * halfExtent * (1.0f / cellSize))));
+    }
+    int dim() const { return dim_; }
+    const uint32_t *cellStart() const { return cellStart_; }
+    const uint32_t *items() const { return items_; }
+    size_t itemCount() const { return dim_ ? cellStart_[static_cast<size_t>(dim_) * dim_] : 0; }
+
+    // fn(index) once for each collider whose rectangle touches the box;
+    // fn returns false to stop.
+    template <typename Fn>
+    void forEach(float minX, float maxX, float minZ, float maxZ, Fn &&fn) const;
+    // Indices of the colliders touching the box, ascending.
+    void query(float minX, float maxX, float minZ, float maxZ, std::vector<uint32_t> &out) const;
+    // Walks the cells under the XZ projection of the ray o + d*t, t in
+    // [0, maxDist], in order (2D DDA) and calls fn(index) for the colliders
+    // listed in each. fn returns how far along the ray the walk still needs
+    // to go (its nearest hit so far, else maxDist); the walk stops at the
+    // first cell starting beyond that. A collider may be reported once per
+    // cell it spans.
+    template <typename Fn>
+    void traceRay(float ox, float oz, float dx, float dz, float maxDist, Fn &&fn) const;
+
+private:
+    struct Box {
+        float minX, maxX, minZ, maxZ;
+    };
+
+    void rebuild(float halfExtent, float cellSize);
+    int cellCoord(float v) const {
+        const int c = static_cast<int>(std::floor((v + half_) * invCell_));
+        return std::max(0, std::min(dim_ - 1, c));
+    }
+
+    const float *box(uint32_t i) const { return boxes_ + static_cast<size_t>(i) * stride_; }
+
+    const float *boxes_ = nullptr; // minX, maxX, minZ, maxZ of each collider, stride_ floats apart
+    uint32_t stride_ = 4;
+    uint32_t count_ = 0;
+    float half_ = 0.0f;
+    float invCell_ = 1.0f;
+    int dim_ = 0;
+    const uint32_t *cellStart_ = nullptr; // per cell + 1: offsets into items_
+    const uint32_t *items_ = nullptr;     // collider indices, grouped by cell
+    // Storage behind the pointers when built here rather than attached.
+    std::vector<Box> ownBoxes_;
+    std::vector<uint32_t> ownCellStart_;
+    std::vector<uint32_t> ownItems_;
+};
+
+template <typename Fn>
+void ColliderGrid::forEach(float minX, float maxX, float minZ, float maxZ, Fn &&fn) const {
+    if (dim_ == 0) return;
+    const int x0 = cellCoord(minX), x1 = cellCoord(maxX);
+    const int z0 = cellCoord(minZ), z1 = cellCoord(maxZ);
+    for (int cz = z0; cz <= z1; ++cz) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            const uint32_t cell = static_cast<uint32_t>(cz * dim_ + cx);
+            for (uint32_t k = cellStart_[cell]; k < cellStart_[cell + 1]; ++k) {
+                const uint32_t i = items_[k];
+                const float *b = box(i);
+                if (b[1] < minX || b[0] > maxX || b[3] < minZ || b[2] > maxZ) continue;
+                // A collider spanning several cells is reported only from the
+                // cell holding the min corner of its overlap with the box.
+                if (cellCoord(std::max(b[0], minX)) != cx || cellCoord(std::max(b[2], minZ)) != cz) continue;
+                if (!fn(i)) return;
+            }
+        }
+    }
+}
+
+template <typename Fn>
+void ColliderGrid::traceRay(float ox, float oz, float dx, float dz, float maxDist, Fn &&fn) const {
+    if (dim_ == 0) return;
+    const float cellSize = 1.0f / invCell_;
+    int cx = cellCoord(ox), cz = cellCoord(oz);
+    const int stepX = dx > 0.0f ? 1 : -1;
+    const int stepZ = dz > 0.0f ? 1 : -1;
+    const float inf = std::numeric_limits<float>::infinity();
+    const float tDeltaX = dx != 0.0f ? cellSize / std::fabs(dx) : inf;
+    const float tDeltaZ = dz != 0.0f ? cellSize / std::fabs(dz) : inf;
+    const float cellMinX = static_cast<float>(cx) * cellSize - half_;
+    const float cellMinZ = static_cast<float>(cz) * cellSize - half_;
+    float tMaxX = dx > 0.0f ? (cellMinX + cellSize - ox) / dx : dx < 0.0f ? (cellMinX - ox) / dx : inf;
+    float tMaxZ = dz > 0.0f ? (cellMinZ + cellSize - oz) / dz : dz < 0.0f ? (cellMinZ - oz) / dz : inf;
+    float limit = maxDist;
+    for (;;) {
+        const uint32_t cell = static_cast<uint32_t>(cz * dim_ + cx);
+        for (uint32_t k = cellStart_[cell]; k < cellStart_[cell + 1]; ++k) limit = std::min(limit, fn(items_[k]));
+        // Anything nearer than limit was in this cell or an earlier one.
+        float t;
+        if (tMaxX < tMaxZ) {
+            t = tMaxX;
+            cx += stepX;
+            tMaxX += tDeltaX;
+        } else {
+            t = tMaxZ;
+            cz += stepZ;
+            tMaxZ += tDeltaZ;
+        }
+        if (t > limit || cx < 0 || cx >= dim_ || cz < 0 || cz >= dim_) return;
+    }
+}
+
+#endif
@@ -0,0 +1,214 @@
+#include "entity_store.h"
+
+#include <algorithm>
+
+void PlayerStore::clear() {
+    x.clear();
+    y.clear();
+    z.clear();
+    vx.clear();
+    vy.clear();
+    vz.clear();
+    yaw.clear();
+    pitch.clear();
+    health.clear();
+    active.clear();
+    grounded.clear();
+    simTick.clear();
+    info.clear();
+}
+
+void PlayerStore::reserve(size_t count) {
+    x.reserve(count);
+    y.reserve(count);
+    z.reserve(count);
+    vx.reserve(count);
+    vy.reserve(count);
+    vz.reserve(count);
+    yaw.reserve(count);
+    pitch.reserve(count);
+    health.reserve(count);
+    active.reserve(count);
+    grounded.reserve(count);
+    simTick.reserve(count);
+    info.reserve(count);
+}
+
+uint32_t PlayerStore::add(uint32_t id, bool isBot) {
+    const uint32_t slot = static_cast<uint32_t>(info.size());
+    x.push_back(0.0f);
+    y.push_back(0.0f);
+    z.push_back(0.0f);
+    vx.push_back(0.0f);
+    vy.push_back(0.0f);
+    vz.push_back(0.0f);
+    yaw.push_back(0.0f);
+    pitch.push_back(0.0f);
+    health.push_back(0);
+    active.push_back(0);
+    grounded.push_back(0);
+    simTick.push_back(kNoTick);
+    PlayerInfo p{};
+    p.id = id;
+    p.isBot = isBot;
+    info.push_back(p);
+    return slot;
+}
+
+void PlayerStore::removeSwap(uint32_t slot) {
+    const size_t last = info.size() - 1;
+    if (slot != last) {
+        x[slot] = x[last];
+        y[slot] = y[last];
+        z[slot] = z[last];
+        vx[slot] = vx[last];
+        vy[slot] = vy[last];
+        vz[slot] = vz[last];
+        yaw[slot] = yaw[last];
+        pitch[slot] = pitch[last];
+        health[slot] = health[last];
+        active[slot] = active[last];
+        grounded[slot] = grounded[last];
+        simTick[slot] = simTick[last];
+        info[slot] = info[last];
+    }
+    x.pop_back();
+    y.pop_back();
+    z.pop_back();
+    vx.pop_back();
+    vy.pop_back();
+    vz.pop_back();
+    yaw.pop_back();
+    pitch.pop_back();
+    health.pop_back();
+    active.pop_back();
+    grounded.pop_back();
+    simTick.pop_back();
+    info.pop_back();
+}
+
+void SlotMap::clear() {
+    std::fill(table_.begin(), table_.end(), Entry{0, kNoSlot});
+    count_ = 0;
+    for (size_t slot = 0; slot < occupied_.size(); ++slot) {
+        if (occupied_[slot]) ++generations_[slot];
+    }
+    std::fill(occupied_.begin(), occupied_.end(), 0);
+}
+
+void SlotMap::reserve(size_t count) {
+    size_t capacity = 16;
+    while (capacity < count * 2) capacity *= 2;
+    if (capacity > table_.size()) rehash(capacity);
+}
+
+uint32_t SlotMap::find(uint32_t id) const {
+    if (table_.empty()) return kNoSlot;
+    for (size_t i = bucket(id);; i = (i + 1) & mask_) {
+        const Entry &e = table_[i];
+        if (e.slot == kNoSlot) return kNoSlot;
+        if (e.id == id) return e.slot;
+    }
+}
+
+void SlotMap::assign(uint32_t id, uint32_t slot) {
+    if ((count_ + 1) * 2 > table_.size()) rehash(std::max<size_t>(16, table_.size() * 2));
+    if (slot >= generations_.size()) {
+        generations_.resize(slot + 1, 0);
+        occupied_.resize(slot + 1, 0);
+    }
+    ++generations_[slot];
+    occupied_[slot] = 1;
+    for (size_t i = bucket(id);; i = (i + 1) & mask_) {
+        Entry &e = table_[i];
+        if (e.slot == kNoSlot) {
+            e = {id, slot};
+            ++count_;
+            return;
+        }
+        if (e.id == id) {
+            e.slot = slot;
+            return;
+        }
+    }
+}
+
+void SlotMap::erase(uint32_t id) {
+    if (table_.empty()) return;
+    size_t i = bucket(id);
+    while (table_[i].slot != kNoSlot && table_[i].id != id) i = (i + 1) & mask_;
+    if (table_[i].slot == kNoSlot) return;
+    // Backward-shift deletion: pull later entries of the probe run into the hole.
+    size_t hole = i;
+    for (size_t j = (i + 1) & mask_; table_[j].slot != kNoSlot; j = (j + 1) & mask_) {
+        const size_t home = bucket(table_[j].id);
+        const bool movable = hole <= j ? (home <= hole || home > j) : (home <= hole && home > j);
+        if (movable) {
+            table_[hole] = table_[j];
+            hole = j;
+        }
+    }
+    table_[hole] = {0, kNoSlot};
+    --count_;
+}
+
+void SlotMap::release(uint32_t slot) {
+    if (slot < occupied_.size() && occupied_[slot]) {
+        ++generations_[slot];
+        occupied_[slot] = 0;
+    }
+}
+
+PlayerHandle SlotMap::handle(uint32_t slot) const {
+    if (slot >= occupied_.size() || !occupied_[slot]) return {};
+    return {slot, generations_[slot]};
+}
+
+uint32_t SlotMap::resolve(const PlayerHandle &handle) const {
+    const uint32_t slot = handle.slot;
+    if (slot >= occupied_.size() || !occupied_[slot] || generations_[slot] != handle.generation) return kNoSlot;
+    return slot;
+}
+
+void SlotMap::rehash(size_t capacity) {
+    std::vector<Entry> old;
+    old.swap(table_);
+    table_.assign(capacity, Entry{0, kNoSlot});
+    mask_ = capacity - 1;
+    count_ = 0;
+    for (const Entry &e : old) {
+        if (e.slot == kNoSlot) continue;
+        size_t i = bucket(e.id);
+        while (table_[i].slot != kNoSlot) i = (i + 1) & mask_;
+        table_[i] = e;
+        ++count_;
+    }
+}
+
+void SpiderStore::clear() {
+    x.clear();
+    y.clear();
+    z.clear();
+    vx.clear();
+    vz.clear();
+    yaw.clear();
+    health.clear();
+    active.clear();
+    info.clear();
+}
+
+uint32_t SpiderStore::add(uint32_t id) {
+    const uint32_t slot = static_cast<uint32_t>(info.size());
+    x.push_back(0.0f);
+    y.push_back(0.0f);
+    z.push_back(0.0f);
+    vx.push_back(0.0f);
+    vz.push_back(0.0f);
+    yaw.push_back(0.0f);
+    health.push_back(0);
+    active.push_back(0);
+    SpiderInfo s{};
+    s.id = id;
+    info.push_back(s);
+    return slot;
+}
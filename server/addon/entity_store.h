@@ -0,0 +1,109 @@
+#ifndef ENTITY_STORE_H
+#define ENTITY_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+constexpr uint32_t kNoSlot = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t kNoTick = std::numeric_limits<uint32_t>::max();
+
+// Per-player bookkeeping that the movement, collision and snapshot loops don't read.
+struct PlayerInfo {
+    uint32_t id;
+    uint32_t lastSeq;
+    uint32_t respawnTick;
+    uint32_t lastFireTick;
+    uint32_t lastInputTick;
+    uint32_t ackTick; // latest snapshot tick the client has decoded
+    uint8_t weapon;
+    bool isBot;
+};
+
+// Players in structure-of-arrays form, indexed by slot. Hot simulation state
+// sits in parallel arrays so per-tick loops stream only the fields they use
+// and can be vectorized across players.
+struct PlayerStore {
+    std::vector<float> x, y, z;
+    std::vector<float> vx, vy, vz;
+    std::vector<float> yaw, pitch;
+    std::vector<int32_t> health;
+    std::vector<uint8_t> active;
+    std::vector<uint8_t> grounded;
+    std::vector<uint32_t> simTick; // tick the player last moved with input, kNoTick if never
+    std::vector<PlayerInfo> info;
+
+    size_t size() const { return info.size(); }
+    void clear();
+    void reserve(size_t count);
+    // Appends a zeroed, inactive player and returns its slot.
+    uint32_t add(uint32_t id, bool isBot);
+    // Moves the last player into slot and shrinks by one.
+    void removeSwap(uint32_t slot);
+};
+
+// Refers to a slot as it was when the handle was taken; stale once that
+// player is removed or another player is moved into the slot.
+struct PlayerHandle {
+    uint32_t slot = kNoSlot;
+    uint32_t generation = 0;
+};
+
+// O(1) id -> slot lookup for a PlayerStore. Open addressing with linear
+// probing; erase shifts later entries back so there are no tombstones. Each
+// slot also has a generation that is bumped whenever its occupant changes.
+class SlotMap {
+public:
+    void clear();
+    void reserve(size_t count);
+    uint32_t find(uint32_t id) const;
+    // Points id at slot (inserting or updating) and starts a new generation for slot.
+    void assign(uint32_t id, uint32_t slot);
+    void erase(uint32_t id);
+    // Ends the current generation of a slot that became empty.
+    void release(uint32_t slot);
+    PlayerHandle handle(uint32_t slot) const;
+    // Slot the handle still refers to, or kNoSlot.
+    uint32_t resolve(const PlayerHandle &handle) const;
+
+private:
+    struct Entry {
+        uint32_t id;
+        uint32_t slot; // kNoSlot = empty
+    };
+    size_t bucket(uint32_t id) const { return (id * 0x9E3779B1u) & mask_; }
+    void rehash(size_t capacity);
+
+    std::vector<Entry> table_;
+    size_t mask_ = 0;
+    size_t count_ = 0;
+    std::vector<uint32_t> generations_; // per slot, never shrinks
+    std::vector<uint8_t> occupied_;     // per slot
+};
+
+struct SpiderInfo {
+    uint32_t id;
+    uint32_t targetPlayerId;
+    uint32_t lastAttackTick;
+    float aggroRange = 18.0f;
+    float attackRange = 1.5f;
+    int32_t attackDamage = 8;
+    uint32_t attackCooldownTicks = 30; // 0.5 seconds at 60Hz
+    float moveSpeed = 5.0f;
+};
+
+struct SpiderStore {
+    std::vector<float> x, y, z;
+    std::vector<float> vx, vz;
+    std::vector<float> yaw;
+    std::vector<int32_t> health;
+    std::vector<uint8_t> active;
+    std::vector<SpiderInfo> info;
+
+    size_t size() const { return info.size(); }
+    void clear();
+    uint32_t add(uint32_t id);
+};
+
+#endif
@@ -2,9 +2,105 @@
 #define GAME_MATH_H
 
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 
 inline float clampf(float v, float lo, float hi) {
     return std::max(lo, std::min(hi, v));
 }
 
+// Bitwise select of a or b. Unlike a ternary, the compiler can't turn this
+// back into a branch, so loops built from it still vectorize.
+inline float selectf(bool c, float a, float b) {
+    uint32_t ia, ib;
+    std::memcpy(&ia, &a, sizeof(ia));
+    std::memcpy(&ib, &b, sizeof(ib));
+    const uint32_t mask = 0u - static_cast<uint32_t>(c);
+    const uint32_t bits = (ia & mask) | (ib & ~mask);
+    float out;
+    std::memcpy(&out, &bits, sizeof(out));
+    return out;
+}
+
+// Fast trig for the simulation's batched hot paths (pellet directions, bot
+// and spider headings). Polynomials in plain float arithmetic with no branch
+// on the argument, so the batched forms vectorize and scalar and batched
+// calls return the same bits. Against double libm
+// (bench case trig_accuracy):
+//   fastSinCos: |error| <= 1.2e-7 for |x| <= kFastTrigRange; larger or
+//               non-finite x go to std::sin / std::cos.
+//   fastAtan2:  |error| <= 3.0e-7 rad for finite arguments; (0, 0) gives 0.
+constexpr float kFastTrigRange = 8192.0f;
+
+namespace fast_trig {
+// sin and cos of x in [-pi/4, pi/4] (Cephes sinf / cosf minimax).
+inline float sinPoly(float r, float r2) {
+    return r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+}
+inline float cosPoly(float r2) {
+    return 1.0f - 0.5f * r2 +
+           r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+}
+
+// x must be within kFastTrigRange; anything else gives garbage, not UB.
+inline void sinCosInRange(float x, float &s, float &c) {
+    // Nearest multiple q of pi/2: adding 1.5 * 2^23 rounds to an integer and
+    // leaves q in the low mantissa bits. It is taken off in three parts (the
+    // first two exact in q * part) so r keeps full precision.
+    constexpr float kRound = 12582912.0f;
+    const float shifted = x * 0.636619772f + kRound;
+    uint32_t q;
+    std::memcpy(&q, &shifted, sizeof(q));
+    const float qf = shifted - kRound;
+    const float r = ((x - qf * 1.5703125f) - qf * 4.837512969970703125e-4f) - qf * 7.54978995489188216e-8f;
+    const float r2 = r * r;
+    const float sr = sinPoly(r, r2);
+    const float cr = cosPoly(r2);
+    const bool odd = (q & 1) != 0;
+    s = selectf(odd, cr, sr) * selectf((q & 2) != 0, -1.0f, 1.0f);
+    c = selectf(odd, sr, cr) * selectf(((q + 1) & 2) != 0, -1.0f, 1.0f);
+}
+} // namespace fast_trig
+
+inline void fastSinCos(float x, float &s, float &c) {
+    if (!(std::fabs(x) <= kFastTrigRange)) {
+        s = std::sin(x);
+        c = std::cos(x);
+        return;
+    }
+    fast_trig::sinCosInRange(x, s, c);
+}
+
+// s[i], c[i] = sin, cos of x[i].
+inline void fastSinCos(const float *x, float *s, float *c, size_t n) {
+    for (size_t i = 0; i < n; ++i) fast_trig::sinCosInRange(x[i], s[i], c[i]);
+    for (size_t i = 0; i < n; ++i) {
+        if (!(std::fabs(x[i]) <= kFastTrigRange)) fastSinCos(x[i], s[i], c[i]);
+    }
+}
+
+inline float fastAtan2(float y, float x) {
+    const float ax = std::fabs(x);
+    const float ay = std::fabs(y);
+    const float hi = std::max(ax, ay);
+    const float t = std::min(ax, ay) / selectf(hi > 0.0f, hi, 1.0f);
+    // atan of t in [0, 1]; past tan(pi/8) as pi/4 + atan((t - 1) / (t + 1)).
+    const bool upper = t > 0.414213562f;
+    const float u = selectf(upper, (t - 1.0f) / (t + 1.0f), t);
+    const float z = u * u;
+    float a =
+        u + u * z * (-3.33329491539e-1f + z * (1.99777106478e-1f + z * (-1.38776856032e-1f + z * 8.05374449538e-2f)));
+    a += selectf(upper, 0.785398163f, 0.0f);
+    a = selectf(ay > ax, 1.57079633f - a, a);
+    a = selectf(x < 0.0f, 3.14159265f - a, a);
+    return selectf(y < 0.0f, -a, a);
+}
+
+// out[i] = atan2(y[i], x[i]).
+inline void fastAtan2(const float *y, const float *x, float *out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = fastAtan2(y[i], x[i]);
+}
+
 #endif
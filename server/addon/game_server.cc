@@ -6,165 +6,317 @@
 #include <chrono>
 #include <iterator>
 
-InputRing::InputRing() : head_(0), tail_(0) {}
+GameServer::GameServer()
+    : running_(false), tickCount_(0), config_{64, 24.0f, 0, {}} {}
 
-bool InputRing::push(const InputPacket &packet) {
-    const size_t head = head_.load(std::memory_order_relaxed);
-    const size_t next = (head + 1) % kSize;
-    if (next == tail_.load(std::memory_order_acquire)) {
-        return false; // full, drop
-    }
-    buffer_[head] = packet;
-    head_.store(next, std::memory_order_release);
-    return true;
+GameServer::~GameServer() { stop(); }
+
+void GameServer::start(const GameConfig &config, const SchedulerConfig &scheduler) {
+    if (running_.load()) return;
+    reset(config);
+    scheduler_ = scheduler;
+    running_.store(true);
+    tickThread_ = std::thread(&GameServer::tickLoop, this);
 }
 
-bool InputRing::pop(InputPacket &packet) {
-    const size_t tail = tail_.load(std::memory_order_relaxed);
-    if (tail == head_.load(std::memory_order_acquire)) {
-        return false; // empty
-    }
-    packet = buffer_[tail];
-    const size_t next = (tail + 1) % kSize;
-    tail_.store(next, std::memory_order_release);
-    return true;
+void GameServer::startHeadless(const GameConfig &config) {
+    if (running_.load()) return;
+    reset(config);
 }
 
-GameServer::GameServer()
-    : running_(false), tickCount_(0), config_{64, 24.0f, 0} {}
+void GameServer::step(float dt) {
+    stepSimulation(dt);
+}
 
-GameServer::~GameServer() { stop(); }
+void GameServer::stepReplay(const std::vector<InputPacket> &inputs, float dt) {
+    stepSimulation(dt, &inputs);
+}
 
-void GameServer::start(const GameConfig &config) {
-    if (running_.load()) return;
+void GameServer::reset(const GameConfig &config) {
     config_ = config;
     setupMap();
-    running_.store(true);
     tickCount_.store(0);
     players_.clear();
-    snapshot_.clear();
-    tickThread_ = std::thread(&GameServer::tickLoop, this);
+    players_.reserve(config_.maxPlayers);
+    slots_.clear();
+    slots_.reserve(config_.maxPlayers);
+    inputQueues_.clear();
+    inputQueues_.reserve(config_.maxPlayers);
+    lanes_.configure(config_.inputRate);
+    {
+        std::lock_guard<std::mutex> lock(inputStatsMutex_);
+        inputStats_.clear();
+    }
+    botHandles_.assign(config_.botCount, PlayerHandle{});
+    idle_.clear();
+    // Cells a bit larger than a shotgun's spread at close range keep most queries to a few cells.
+    grid_.reset(config_.worldHalfExtent, 4.0f);
+    positions_.reset(config_.maxPlayers, config_.worldHalfExtent);
+    seed_ = config_.seed;
+    while (seed_ == 0) seed_ = std::random_device{}();
+    rng_.seed(seed_);
+    if (!config_.recordPath.empty()) {
+        InputLogHeader header;
+        header.seed = seed_;
+        header.maxPlayers = config_.maxPlayers;
+        header.worldHalfExtent = config_.worldHalfExtent;
+        header.botCount = config_.botCount;
+        header.inputBufferDepth = config_.inputBufferDepth;
+        header.maxRewindTicks = config_.maxRewindTicks;
+        header.snapshotPrecision = config_.snapshotPrecision;
+        if (map_) header.mapPath = config_.mapPath;
+        recorder_.open(config_.recordPath, header);
+    } else {
+        recorder_.close();
+    }
+    snapshots_.clear();
+    history_.clear();
+    interest_.reset(config_.interestRadius, config_.interestMargin);
+    quantizer_ = SnapshotQuantizer(config_.snapshotPrecision, config_.worldHalfExtent);
+    profiler_.reset();
 }
 
 void GameServer::stop() {
-    if (!running_.load()) return;
-    running_.store(false);
-    if (tickThread_.joinable()) tickThread_.join();
+    if (running_.exchange(false) && tickThread_.joinable()) tickThread_.join();
+    // Pooled rooms never run the tick thread but still record.
+    recorder_.close();
 }
 
-bool GameServer::pushInput(const InputPacket &packet) {
-    return ring_.push(packet);
+bool GameServer::pushInput(const InputPacket &packet, uint32_t lane) {
+    if (lanes_.push(lane, packet)) return true;
+    profiler_.dropInput();
+    return false;
 }
 
-void GameServer::getSnapshot(std::vector<uint8_t> &outSnapshot) {
-    std::lock_guard<std::mutex> lock(snapshotMutex_);
-    outSnapshot = snapshot_;
+SnapshotView GameServer::getSnapshot() const {
+    return snapshots_.acquire();
 }
 
 void GameServer::tickLoop() {
-    using clock = std::chrono::steady_clock;
     const double dt = 1.0 / 60.0;
-    auto nextTime = clock::now();
-    const auto step = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(dt));
+    TickWaiter waiter(scheduler_);
+    TickSchedule schedule;
+    schedule.period = std::chrono::duration_cast<TickClock::duration>(std::chrono::duration<double>(dt));
+    schedule.deadline = TickClock::now() + schedule.period;
     while (running_.load()) {
-        nextTime += step;
+        waiter.waitUntil(schedule.deadline);
+        const TickClock::time_point start = TickClock::now();
+        profiler_.recordStartLag(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(start - schedule.deadline).count()));
         stepSimulation(static_cast<float>(dt));
-        std::this_thread::sleep_until(nextTime);
+        profiler_.addSkipped(schedule.advance(scheduler_, TickClock::now()));
     }
 }
 
-void GameServer::stepSimulation(float dt) {
-    std::vector<uint32_t> touched;
-    InputPacket pkt;
-    while (ring_.pop(pkt)) {
-        processInput(pkt, dt, touched);
+void GameServer::stepSimulation(float dt, const std::vector<InputPacket> *replay) {
+    const uint64_t start = TickProfiler::now();
+    uint32_t inputs = 0;
+    if (replay) {
+        for (const InputPacket &packet : *replay) queueInput(packet);
+        inputs = static_cast<uint32_t>(replay->size());
+    } else {
+        inputs = lanes_.drain([this](const InputPacket &packet) { queueInput(packet); });
     }
+    consumeInputs(dt);
+    profiler_.addInputs(inputs);
+    const uint64_t inputDone = TickProfiler::now();
+    profiler_.record(TickPhase::Input, inputDone - start);
 
-    updateBots(dt, touched);
+    updateBots(dt);
+    const uint64_t botsDone = TickProfiler::now();
+    profiler_.record(TickPhase::Bots, botsDone - inputDone);
 
-    for (auto &p : players_) {
-        if (!p.active) {
-            if (tickCount_.load() >= p.respawnTick) {
-                respawnPlayer(p);
+    const uint32_t tick = tickCount_.load();
+    const uint32_t count = static_cast<uint32_t>(players_.size());
+    idle_.assign(count, 0);
+    for (uint32_t i = 0; i < count; ++i) {
+        const PlayerInfo &info = players_.info[i];
+        if (!players_.active[i]) {
+            if (tick >= info.respawnTick) {
+                respawnPlayer(i);
             }
             continue;
         }
-        if (std::find(touched.begin(), touched.end(), p.id) == touched.end()) {
-            InputPacket idle{};
-            idle.yaw = p.yaw;
-            idle.pitch = p.pitch;
-            idle.weapon = p.weapon;
-            integratePlayer(p, idle, dt);
-        }
+        idle_[i] = players_.simTick[i] != tick ? 1 : 0;
+    }
+    integrateIdle(dt);
 
-        if (!p.isBot && tickCount_.load() - p.lastInputTick > 600) {
-            p.active = false;
-            continue;
+    // Humans silent for 10 s are dropped; they rejoin on their next packet.
+    for (uint32_t i = count; i-- > 0;) {
+        const PlayerInfo &info = players_.info[i];
+        if (!info.isBot && tick - info.lastInputTick > 600) {
+            removePlayer(i);
         }
     }
 
+    const uint64_t simulateDone = TickProfiler::now();
+    profiler_.record(TickPhase::Simulate, simulateDone - botsDone);
+
+    if (tick % 30 == 0) publishInputStats();
     tickCount_.fetch_add(1);
+    positions_.record(tick + 1, static_cast<uint32_t>(players_.size()), players_.x.data(), players_.y.data(),
+                      players_.z.data());
+    if (recorder_.isOpen()) recorder_.endTick(tick + 1, dt, stateHash());
     buildSnapshot();
+    const uint64_t end = TickProfiler::now();
+    profiler_.record(TickPhase::Snapshot, end - simulateDone);
+    profiler_.endTick(end - start, static_cast<uint64_t>(dt * 1e9f));
 }
 
 void GameServer::buildSnapshot() {
-    std::vector<uint8_t> data;
-    data.reserve(4 + 2 + players_.size() * 64);
-    auto writeBytes = [&data](const void *ptr, size_t len) {
-        const uint8_t *b = static_cast<const uint8_t *>(ptr);
-        data.insert(data.end(), b, b + len);
-    };
     const uint32_t tick = tickCount_.load();
-    const uint16_t count = static_cast<uint16_t>(players_.size());
-    writeBytes(&tick, sizeof(tick));
-    writeBytes(&count, sizeof(count));
-    for (const auto &p : players_) {
-        writeBytes(&p.id, sizeof(p.id));
-        writeBytes(&p.x, sizeof(p.x));
-        writeBytes(&p.y, sizeof(p.y));
-        writeBytes(&p.z, sizeof(p.z));
-        writeBytes(&p.vx, sizeof(p.vx));
-        writeBytes(&p.vy, sizeof(p.vy));
-        writeBytes(&p.vz, sizeof(p.vz));
-        writeBytes(&p.yaw, sizeof(p.yaw));
-        writeBytes(&p.pitch, sizeof(p.pitch));
-        int16_t health = static_cast<int16_t>(p.health);
-        writeBytes(&health, sizeof(health));
-        uint8_t active = p.active ? 1 : 0;
-        writeBytes(&active, sizeof(active));
-        uint8_t isBot = p.isBot ? 1 : 0;
-        writeBytes(&isBot, sizeof(isBot));
-        writeBytes(&p.weapon, sizeof(p.weapon));
-        writeBytes(&p.lastSeq, sizeof(p.lastSeq));
+    std::vector<EntitySnapshot> &current = history_.begin(tick);
+    const size_t count = players_.size();
+    current.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const PlayerInfo &info = players_.info[i];
+        EntitySnapshot e{};
+        e.id = info.id;
+        e.x = quantizer_.position(players_.x[i]);
+        e.y = quantizer_.height(players_.y[i]);
+        e.z = quantizer_.position(players_.z[i]);
+        e.vx = quantizer_.velocity(players_.vx[i]);
+        e.vy = quantizer_.velocity(players_.vy[i]);
+        e.vz = quantizer_.velocity(players_.vz[i]);
+        e.yaw = quantizer_.yaw(players_.yaw[i]);
+        e.pitch = quantizer_.pitch(players_.pitch[i]);
+        e.health = static_cast<uint8_t>(std::max(0, std::min(255, players_.health[i])));
+        e.active = players_.active[i];
+        e.isBot = info.isBot ? 1 : 0;
+        e.weapon = info.weapon;
+        e.lastSeq = info.lastSeq;
+        current.push_back(e);
+    }
+    std::sort(current.begin(), current.end(),
+              [](const EntitySnapshot &a, const EntitySnapshot &b) { return a.id < b.id; });
+
+    SnapshotFrame *frame = snapshots_.beginFrame();
+    std::vector<uint8_t> &data = frame->data;
+    data.clear();
+    frame->clients.clear();
+    encodeSnapshot(tick, 0, quantizer_, nullptr, current, 0, data);
+    frame->full = {0, 0, static_cast<uint32_t>(data.size())};
+
+    // Each human gets a delta against the last tick it acked, if still in history.
+    for (size_t i = 0; i < count; ++i) {
+        const PlayerInfo &p = players_.info[i];
+        if (p.isBot) continue;
+        const std::vector<EntitySnapshot> *base = p.ackTick != 0 ? history_.find(p.ackTick) : nullptr;
+        const uint32_t offset = static_cast<uint32_t>(data.size());
+        if (interest_.enabled()) {
+            // Only players in its interest set, against what it was sent at the acked tick.
+            nearby_.clear();
+            const float px = players_.x[i];
+            const float pz = players_.z[i];
+            grid_.queryRadius(px, pz, interest_.exitRadius(), [&](uint32_t slot) {
+                const float dx = players_.x[slot] - px;
+                const float dz = players_.z[slot] - pz;
+                nearby_.emplace_back(players_.info[slot].id, dx * dx + dz * dz);
+            });
+            InterestSets::select(current, interest_.update(p.id, tick, nearby_), visible_);
+            const std::vector<uint32_t> *seen = base ? interest_.find(p.id, p.ackTick) : nullptr;
+            if (seen) InterestSets::select(*base, *seen, visibleBase_);
+            encodeSnapshot(tick, p.ackTick, quantizer_, seen ? &visibleBase_ : nullptr, visible_, p.id, data);
+        } else {
+            encodeSnapshot(tick, p.ackTick, quantizer_, base, current, p.id, data);
+        }
+        frame->clients.push_back({p.id, offset, static_cast<uint32_t>(data.size()) - offset});
+    }
+    std::sort(frame->clients.begin(), frame->clients.end(),
+              [](const SnapshotSlice &a, const SnapshotSlice &b) { return a.clientId < b.clientId; });
+
+    frame->tick = tick;
+    profiler_.addSnapshotBytes(static_cast<uint32_t>(data.size()));
+    snapshots_.publish(frame);
+}
+
+uint32_t GameServer::findPlayer(uint32_t id) const {
+    return slots_.find(id);
+}
+
+uint32_t GameServer::addPlayer(uint32_t id, bool isBot) {
+    const uint32_t slot = players_.add(id, isBot);
+    slots_.assign(id, slot);
+    inputQueues_.emplace_back();
+    inputQueues_.back().reset(config_.inputBufferDepth);
+    positions_.restart(slot, tickCount_.load() + 1);
+    return slot;
+}
+
+void GameServer::removePlayer(uint32_t slot) {
+    const uint32_t last = static_cast<uint32_t>(players_.size()) - 1;
+    const bool lastInGrid = grid_.contains(last);
+    grid_.remove(slot);
+    grid_.remove(last);
+    slots_.erase(players_.info[slot].id);
+    interest_.forget(players_.info[slot].id);
+    slots_.release(slot);
+    slots_.release(last);
+    players_.removeSwap(slot);
+    positions_.removeSwap(slot);
+    inputQueues_[slot] = inputQueues_[last];
+    inputQueues_.pop_back();
+    if (slot == last) return;
+    slots_.assign(players_.info[slot].id, slot);
+    if (lastInGrid) grid_.insert(slot, players_.x[slot], players_.z[slot]);
+}
+
+uint64_t GameServer::stateHash() const {
+    StateHasher h;
+    const uint32_t tick = tickCount_.load();
+    h.add(&tick, sizeof(tick));
+    h.add(players_.x);
+    h.add(players_.y);
+    h.add(players_.z);
+    h.add(players_.vx);
+    h.add(players_.vy);
+    h.add(players_.vz);
+    h.add(players_.yaw);
+    h.add(players_.pitch);
+    h.add(players_.health);
+    h.add(players_.active);
+    h.add(players_.grounded);
+    for (const PlayerInfo &info : players_.info) {
+        const uint32_t fields[] = {info.id, info.lastSeq, info.respawnTick, info.lastFireTick};
+        h.add(fields, sizeof(fields));
     }
+    h.add(spiders_.x);
+    h.add(spiders_.y);
+    h.add(spiders_.z);
+    h.add(spiders_.vx);
+    h.add(spiders_.vz);
+    h.add(spiders_.health);
+    h.add(spiders_.active);
+    return h.value();
+}
 
-    std::lock_guard<std::mutex> lock(snapshotMutex_);
-    snapshot_.swap(data);
+std::vector<PlayerInputStats> GameServer::inputStats() const {
+    std::lock_guard<std::mutex> lock(inputStatsMutex_);
+    return inputStats_;
 }
 
-PlayerState *GameServer::findPlayer(uint32_t id) {
-    for (auto &p : players_) {
-        if (p.id == id) return &p;
+void GameServer::publishInputStats() {
+    std::unordered_map<uint32_t, InputDrops> drops;
+    lanes_.collectDrops(drops);
+    std::lock_guard<std::mutex> lock(inputStatsMutex_);
+    inputStats_.clear();
+    for (uint32_t i = 0; i < players_.size(); ++i) {
+        if (players_.info[i].isBot) continue;
+        const auto it = drops.find(players_.info[i].id);
+        inputStats_.push_back(
+            {players_.info[i].id, inputQueues_[i].stats(), it != drops.end() ? it->second : InputDrops{}});
     }
-    return nullptr;
-}
-
-PlayerState *GameServer::ensureBot(uint32_t botId) {
-    if (config_.botCount == 0) return nullptr;
-    PlayerState *p = findPlayer(botId);
-    if (p) return p;
-    if (players_.size() >= config_.maxPlayers) return nullptr;
-    PlayerState bot{};
-    bot.id = botId;
-    bot.health = 100;
-    bot.yaw = 0;
-    bot.pitch = 0;
-    bot.active = true;
-    bot.lastSeq = 0;
-    bot.lastInputTick = tickCount_.load();
-    bot.weapon = 0;
-    bot.isBot = true;
-    respawnPlayer(bot);
-    players_.push_back(bot);
-    return &players_.back();
+}
+
+uint32_t GameServer::ensureBot(uint32_t botId) {
+    if (config_.botCount == 0) return kNoSlot;
+    const uint32_t existing = findPlayer(botId);
+    if (existing != kNoSlot) return existing;
+    if (players_.size() >= config_.maxPlayers) return kNoSlot;
+    const uint32_t slot = addPlayer(botId, true);
+    players_.health[slot] = 100;
+    players_.active[slot] = 1;
+    players_.info[slot].lastInputTick = tickCount_.load();
+    respawnPlayer(slot);
+    return slot;
 }
@@ -3,100 +3,53 @@
 
 #include <atomic>
 #include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 #include <array>
-#include <mutex>
+
+#include "collider_grid.h"
+#include "entity_store.h"
+#include "input_lanes.h"
+#include "input_log.h"
+#include "input_queue.h"
+#include "interest_sets.h"
+#include "map_file.h"
+#include "snapshot_buffer.h"
+#include "pellet_kernel.h"
+#include "position_history.h"
+#include "snapshot_codec.h"
+#include "spatial_grid.h"
+#include "tick_profiler.h"
+#include "tick_scheduler.h"
 
 enum class EntityType : uint8_t {
     PLAYER = 0,
     SPIDER = 1,
 };
 
-struct InputPacket {
-    uint32_t playerId;
-    uint32_t seq;
-    float moveX;
-    float moveZ;
-    float yaw;
-    float pitch;
-    bool fire;
-    uint8_t weapon;
-    bool jump;
-};
-
-struct PlayerState {
-    uint32_t id;
-    float x;
-    float y;
-    float z;
-    float vx;
-    float vy;
-    float vz;
-    float yaw;
-    float pitch;
-    int32_t health;
-    uint32_t lastSeq;
-    bool active;
-    uint32_t respawnTick;
-    uint32_t lastFireTick;
-    uint32_t lastInputTick;
-    uint8_t weapon;
-    bool isBot;
-    bool grounded;
-};
-
 struct GameConfig {
     uint32_t maxPlayers;
     float worldHalfExtent;
     uint32_t botCount;
+    SnapshotPrecision snapshotPrecision;
+    uint32_t inputBufferDepth = 1; // commands buffered per player before the first is applied
+    InputRateLimit inputRate{};    // per player, checked by each producer
+    uint32_t maxRewindTicks = 12;  // lag compensation limit, at most PositionHistory::kDepth - 1; 0 disables
+    uint32_t seed = 0;             // room RNG seed; 0 picks one at start
+    std::string recordPath{};      // input log for replayInputLog(); empty disables
+    float interestRadius = 0.0f;   // clients are sent players within this distance; 0 sends everyone
+    float interestMargin = 5.0f;   // extra distance before a player leaves a client's set
+    std::string mapPath{};         // binary map (map_file.h), which also sets worldHalfExtent; empty uses the built-in map
 };
 
-struct Wall {
-    float minX;
-    float maxX;
-    float minZ;
-    float maxZ;
-};
-
-struct Platform {
-    float minX;
-    float maxX;
-    float minZ;
-    float maxZ;
-    float height;
-};
-
-struct SpiderEntity {
-    uint32_t id;
-    float x;
-    float y;
-    float z;
-    float vx;
-    float vz;
-    float yaw;
-    int32_t health;
-    bool active;
-    uint32_t targetPlayerId;
-    uint32_t lastAttackTick;
-    float aggroRange = 18.0f;
-    float attackRange = 1.5f;
-    int32_t attackDamage = 8;
-    uint32_t attackCooldownTicks = 30; // 0.5 seconds at 60Hz
-    float moveSpeed = 5.0f;
-};
-
-class InputRing {
-public:
-    InputRing();
-    bool push(const InputPacket &packet);
-    bool pop(InputPacket &packet);
-
-private:
-    static constexpr size_t kSize = 4096;
-    std::array<InputPacket, kSize> buffer_;
-    std::atomic<size_t> head_;
-    std::atomic<size_t> tail_;
+struct PlayerInputStats {
+    uint32_t playerId;
+    InputQueueStats queue;
+    InputDrops drops; // refused before reaching the queue
 };
 
 class GameServer {
@@ -104,46 +57,119 @@ public:
     GameServer();
     ~GameServer();
 
-    void start(const GameConfig &config);
+    void start(const GameConfig &config, const SchedulerConfig &scheduler = {});
+    // Same world setup without the tick thread; the caller advances it with step().
+    void startHeadless(const GameConfig &config);
+    void step(float dt);
+    // Steps a headless server with these commands instead of the queued ones.
+    void stepReplay(const std::vector<InputPacket> &inputs, float dt);
+    // Hash of the simulated state (players, spiders, tick).
+    uint64_t stateHash() const;
+    uint32_t seed() const { return seed_; }
+    // Joins the tick thread, if running, and closes the input log.
     void stop();
-    bool pushInput(const InputPacket &packet);
-    void getSnapshot(std::vector<uint8_t> &outSnapshot);
+    // Each producer thread pushes into its own lane (inputLanes().claim());
+    // the owner lane is for the thread that started the room.
+    bool pushInput(const InputPacket &packet, uint32_t lane = InputLanes::kOwnerLane);
+    InputLanes &inputLanes() { return lanes_; }
+    SnapshotView getSnapshot() const;
+    const TickProfiler &profiler() const { return profiler_; }
+    TickProfiler &profiler() { return profiler_; }
+    // Jitter buffer counters per human player, refreshed twice a second.
+    std::vector<PlayerInputStats> inputStats() const;
 
 private:
+    friend struct BenchAccess; // bench/ drives single phases directly
+
+    void reset(const GameConfig &config);
     void tickLoop();
-    void stepSimulation(float dt);
-    void processInput(const InputPacket &packet, float dt, std::vector<uint32_t> &touchedIds);
-    void integratePlayer(PlayerState &p, const InputPacket &input, float dt);
-    void respawnPlayer(PlayerState &p);
+    // Drains the input lanes, or takes replay's commands when given.
+    void stepSimulation(float dt, const std::vector<InputPacket> *replay = nullptr);
+    // Applies a command immediately (bots).
+    void processInput(const InputPacket &packet, float dt);
+    // Buffers a client command; consumeInputs applies one per player per tick.
+    void queueInput(const InputPacket &packet);
+    void consumeInputs(float dt);
+    uint32_t admitPlayer(const InputPacket &packet);
+    void applyInput(uint32_t slot, const InputPacket &packet, float dt);
+    void publishInputStats();
+    void integratePlayer(uint32_t slot, const InputPacket &input, float dt);
+    void integrateIdle(float dt);
+    void respawnPlayer(uint32_t slot);
     void buildSnapshot();
-    void updateBots(float dt, std::vector<uint32_t> &touchedIds);
-    void updateSpiders(float dt, std::vector<uint32_t> &touchedIds);
-    PlayerState *findPlayer(uint32_t id);
-    PlayerState *ensureBot(uint32_t botId);
-    PlayerState *findNearestPlayer(const SpiderEntity &spider);
+    void updateBots(float dt);
+    void updateSpiders(float dt);
+    uint32_t findPlayer(uint32_t id) const;
+    uint32_t ensureBot(uint32_t botId);
+    uint32_t addPlayer(uint32_t id, bool isBot);
+    // Swap-removes a player; the last slot's player moves into slot.
+    void removePlayer(uint32_t slot);
+    uint32_t findNearestPlayer(uint32_t spider) const;
+    // Loads config_.mapPath, or the built-in map if there is none or it fails to load.
     void setupMap();
-    void resolveWalls(PlayerState &p);
-    void resolveSpiderWalls(SpiderEntity &spider);
-    void resolvePlatforms(PlayerState &p);
-    bool overlapsWall(const PlayerState &p, const Wall &w) const;
+    void loadMap(const MapFile &map);
+    // Rebuilds the collider grids from walls_ and platforms_.
+    void buildColliders();
+    // Player that moved from (fromX, fromZ) this tick.
+    void resolveWalls(uint32_t slot, float fromX, float fromZ);
+    // Collision passes over slots [begin, end) whose mask byte is set, after
+    // moving them from (fromX, fromZ), or by their velocity over dt.
+    void resolveWalls(uint32_t begin, uint32_t end, const uint8_t *mask, const float *fromX, const float *fromZ);
+    void resolvePlatforms(uint32_t begin, uint32_t end, const uint8_t *mask, float dt);
+    void resolveSpiderWalls(uint32_t spider, float fromX, float fromZ);
+    // Moves a box of half-size r from (fromX, fromZ) toward (x, z), stopping
+    // at the first wall in the way and sliding along it.
+    void sweepWalls(float r, float fromX, float fromZ, float &x, float &z, float &vx, float &vz);
+    void pushOutOfWalls(float fromX, float fromZ, float &x, float &z, float &vx, float &vz);
+    template <typename Collide>
+    void collideInOrder(const ColliderGrid &grid, size_t count, float r, float fromX, float fromZ, const float &x,
+                        const float &z, Collide &&collide);
+    bool overlapsWall(float x, float z, const Wall &w) const;
+    bool blockedByWall(float x, float z) const;
+    // Distance along a unit ray to the first wall or platform it enters, or
+    // maxDist if there is none that close.
+    float staticRayDistance(float ox, float oy, float oz, float dx, float dy, float dz, float maxDist) const;
     void spawnSpider(float x, float z);
 
-    bool raycastHit(const float ox, const float oy, const float oz,
-                    const float dirX, const float dirY, const float dirZ,
-                    const PlayerState &target, float maxDist, float &hitDist) const;
-
     std::thread tickThread_;
     std::atomic<bool> running_;
     std::atomic<uint32_t> tickCount_;
-    InputRing ring_;
-    std::vector<PlayerState> players_;
-    std::vector<SpiderEntity> spiders_;
+    InputLanes lanes_;
+    PlayerStore players_;
+    SlotMap slots_; // player id -> slot
+    std::vector<InputQueue> inputQueues_; // per slot
+    mutable std::mutex inputStatsMutex_;
+    std::vector<PlayerInputStats> inputStats_;
+    std::vector<PlayerHandle> botHandles_; // by bot index, revalidated each tick
+    std::vector<uint8_t> idle_; // per slot: integrate without input this tick
+    SpatialGrid grid_; // player slots by position
+    PositionHistory positions_; // per-slot positions of recent ticks, for rewinding shots
+    SphereTargets shotTargets_; // candidates for the current shot
+    std::vector<std::pair<uint32_t, float>> shotHits_;
+    SpiderStore spiders_;
     uint32_t nextSpiderId_ = 2000000;
     GameConfig config_;
-    std::mutex snapshotMutex_;
-    std::vector<uint8_t> snapshot_;
+    SchedulerConfig scheduler_;
+    SnapshotPublisher snapshots_;
+    SnapshotHistory history_;
+    SnapshotQuantizer quantizer_;
+    InterestSets interest_; // per-client player sets, by tick
+    std::vector<std::pair<uint32_t, float>> nearby_; // scratch: (id, squared distance) around a viewer
+    std::vector<EntitySnapshot> visible_;     // scratch: a client's share of the current tick
+    std::vector<EntitySnapshot> visibleBase_; // scratch: what it was sent at its acked tick
+    TickProfiler profiler_;
+    uint32_t seed_ = 0;
+    std::mt19937 rng_; // spread and respawns; seeded per room so replays repeat
+    InputLogWriter recorder_;
+    std::shared_ptr<const MapFile> map_; // backs the grids when loaded from a file
     std::vector<Wall> walls_;
     std::vector<Platform> platforms_;
+    std::vector<SpawnPoint> spawns_;
+    ColliderGrid wallGrid_;     // empty for a handful of walls, which are looped over
+    ColliderGrid platformGrid_;
+    std::vector<uint32_t> colliderHits_; // scratch: colliders near the entity being resolved
+    float minWallHalfWidth_ = 0.0f; // half the thinnest wall: shorter moves can't cross one
+    std::vector<float> moveFromX_, moveFromZ_; // scratch: idle players' positions before this tick's move
     float playerRadius_ = 0.35f;
     float spiderRadius_ = 0.4f;
 };
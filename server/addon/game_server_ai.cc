@@ -3,116 +3,108 @@
 #include "weapon_defs.h"
 
 #include <cmath>
-#include <limits>
 
-void GameServer::updateBots(float dt, std::vector<uint32_t> &touched) {
+void GameServer::updateBots(float dt) {
     if (config_.botCount == 0) return;
     for (uint32_t i = 0; i < config_.botCount; ++i) {
         const uint32_t botId = 1000000 + i;
-        PlayerState *bot = ensureBot(botId);
-        if (!bot) continue;
-        if (!bot->active) {
-            if (tickCount_.load() < bot->respawnTick) continue;
-            respawnPlayer(*bot);
+        uint32_t bot = slots_.resolve(botHandles_[i]);
+        if (bot == kNoSlot) {
+            bot = ensureBot(botId);
+            if (bot == kNoSlot) continue;
+            botHandles_[i] = slots_.handle(bot);
         }
-        PlayerState *target = nullptr;
-        float bestDist2 = std::numeric_limits<float>::max();
-        for (auto &p : players_) {
-            if (p.isBot || !p.active || p.health <= 0) continue;
-            const float dx = p.x - bot->x;
-            const float dz = p.z - bot->z;
-            const float d2 = dx * dx + dz * dz;
-            if (d2 < bestDist2) {
-                bestDist2 = d2;
-                target = &p;
-            }
+        if (!players_.active[bot]) {
+            if (tickCount_.load() < players_.info[bot].respawnTick) continue;
+            respawnPlayer(bot);
         }
+        const float botX = players_.x[bot];
+        const float botZ = players_.z[bot];
+        float bestDist2 = 0.0f;
+        const float searchRadius = config_.worldHalfExtent * 3.0f; // covers the whole map
+        const uint32_t target = grid_.nearest(botX, botZ, searchRadius, [this](uint32_t i) {
+            return !players_.info[i].isBot && players_.active[i] && players_.health[i] > 0;
+        }, bestDist2);
         InputPacket ai{};
         ai.playerId = botId;
         ai.seq = tickCount_.load();
         ai.weapon = 0;
-        if (target) {
-            const float dx = target->x - bot->x;
-            const float dz = target->z - bot->z;
-            ai.yaw = std::atan2(-dx, -dz);
+        if (target != SpatialGrid::kNone) {
+            const float dx = players_.x[target] - botX;
+            const float dz = players_.z[target] - botZ;
+            ai.yaw = fastAtan2(-dx, -dz);
             ai.pitch = 0.0f;
             const float dist = std::sqrt(bestDist2);
             ai.moveZ = dist > 2.5f ? 1.0f : 0.0f;
             ai.moveX = (tickCount_.load() / 60) % 2 == 0 ? 0.5f : -0.5f;
             ai.fire = dist < kShotgun.range * 0.9f;
         } else {
-            ai.yaw = bot->yaw;
-            ai.pitch = bot->pitch;
+            ai.yaw = players_.yaw[bot];
+            ai.pitch = players_.pitch[bot];
             ai.moveX = 0.0f;
             ai.moveZ = 0.0f;
             ai.fire = false;
         }
-        processInput(ai, dt, touched);
+        processInput(ai, dt);
     }
 }
 
-void GameServer::updateSpiders(float dt, std::vector<uint32_t> &touched) {
-    (void)touched;
+void GameServer::updateSpiders(float dt) {
     const uint32_t tick = tickCount_.load();
-    for (auto &spider : spiders_) {
-        if (!spider.active) continue;
+    for (uint32_t s = 0; s < spiders_.size(); ++s) {
+        if (!spiders_.active[s]) continue;
+        SpiderInfo &spider = spiders_.info[s];
 
-        PlayerState *target = findNearestPlayer(spider);
+        const uint32_t target = findNearestPlayer(s);
 
-        if (target) {
-            spider.targetPlayerId = target->id;
-            const float dx = target->x - spider.x;
-            const float dz = target->z - spider.z;
+        if (target != kNoSlot) {
+            spider.targetPlayerId = players_.info[target].id;
+            const float dx = players_.x[target] - spiders_.x[s];
+            const float dz = players_.z[target] - spiders_.z[s];
             const float dist = std::sqrt(dx * dx + dz * dz);
 
             if (dist > spider.attackRange) {
-                spider.yaw = std::atan2(-dx, -dz);
+                spiders_.yaw[s] = fastAtan2(-dx, -dz);
                 const float dirX = dx / dist;
                 const float dirZ = dz / dist;
-                spider.vx = dirX * spider.moveSpeed;
-                spider.vz = dirZ * spider.moveSpeed;
-                spider.x += spider.vx * dt;
-                spider.z += spider.vz * dt;
+                spiders_.vx[s] = dirX * spider.moveSpeed;
+                spiders_.vz[s] = dirZ * spider.moveSpeed;
+                const float fromX = spiders_.x[s];
+                const float fromZ = spiders_.z[s];
+                spiders_.x[s] += spiders_.vx[s] * dt;
+                spiders_.z[s] += spiders_.vz[s] * dt;
 
                 const float h = config_.worldHalfExtent;
-                spider.x = clampf(spider.x, -h, h);
-                spider.z = clampf(spider.z, -h, h);
+                spiders_.x[s] = clampf(spiders_.x[s], -h, h);
+                spiders_.z[s] = clampf(spiders_.z[s], -h, h);
 
-                resolveSpiderWalls(spider);
+                resolveSpiderWalls(s, fromX, fromZ);
             } else {
                 if (tick - spider.lastAttackTick >= spider.attackCooldownTicks) {
-                    target->health -= spider.attackDamage;
+                    players_.health[target] -= spider.attackDamage;
                     spider.lastAttackTick = tick;
-                    if (target->health <= 0) {
-                        target->active = false;
-                        target->respawnTick = tick + 180;
+                    if (players_.health[target] <= 0) {
+                        players_.active[target] = 0;
+                        players_.info[target].respawnTick = tick + 180;
                     }
                 }
-                spider.vx = 0.0f;
-                spider.vz = 0.0f;
+                spiders_.vx[s] = 0.0f;
+                spiders_.vz[s] = 0.0f;
             }
         } else {
             spider.targetPlayerId = 0;
-            spider.vx = 0.0f;
-            spider.vz = 0.0f;
+            spiders_.vx[s] = 0.0f;
+            spiders_.vz[s] = 0.0f;
         }
 
-        spider.y = 0.3f;
+        spiders_.y[s] = 0.3f;
     }
 }
 
-PlayerState *GameServer::findNearestPlayer(const SpiderEntity &spider) {
-    PlayerState *target = nullptr;
-    float bestDist2 = spider.aggroRange * spider.aggroRange;
-    for (auto &p : players_) {
-        if (!p.active || p.health <= 0) continue;
-        const float dx = p.x - spider.x;
-        const float dz = p.z - spider.z;
-        const float d2 = dx * dx + dz * dz;
-        if (d2 < bestDist2) {
-            bestDist2 = d2;
-            target = &p;
-        }
-    }
-    return target;
+uint32_t GameServer::findNearestPlayer(uint32_t spider) const {
+    float bestDist2 = 0.0f;
+    const uint32_t slot = grid_.nearest(spiders_.x[spider], spiders_.z[spider], spiders_.info[spider].aggroRange,
+                                        [this](uint32_t i) { return players_.active[i] && players_.health[i] > 0; },
+                                        bestDist2);
+    return slot != SpatialGrid::kNone ? slot : kNoSlot;
 }
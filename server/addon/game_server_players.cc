@@ -8,125 +8,194 @@
 #include <random>
 
 namespace {
-// Safe spawn anchors roughly centered in rooms/corridors to avoid wall overlaps.
-constexpr std::array<std::pair<float, float>, 8> kSpawnPoints{{
-    {-5.0f, -5.0f},
-    {5.0f, -5.0f},
-    {-5.0f, 5.0f},
-    {5.0f, 5.0f},
-    {0.0f, -6.0f},
-    {0.0f, 6.0f},
-    {-8.0f, 0.0f},
-    {8.0f, 0.0f},
-}};
-
-bool raySphereIntersect(const float ox, const float oy, const float oz,
-                        const float dx, const float dy, const float dz,
-                        const float cx, const float cy, const float cz,
-                        const float radius, float maxDist, float &hitDist) {
-    const float lx = cx - ox;
-    const float ly = cy - oy;
-    const float lz = cz - oz;
-    const float tca = lx * dx + ly * dy + lz * dz;
-    if (tca < 0.0f) return false;
-    const float d2 = lx * lx + ly * ly + lz * lz - tca * tca;
-    const float r2 = radius * radius;
-    if (d2 > r2) return false;
-    const float thc = std::sqrt(std::max(0.0f, r2 - d2));
-    const float t0 = tca - thc;
-    const float t1 = tca + thc;
-    const float tHit = (t0 >= 0.0f) ? t0 : t1;
-    hitDist = tHit;
-    return tHit >= 0.0f && tHit <= maxDist;
+constexpr float kHitRadius = 0.6f;
+constexpr float kAccel = 50.0f;
+constexpr float kMaxSpeed = 12.0f;
+constexpr float kFriction = 8.0f;
+constexpr float kGravity = 26.0f;
+constexpr float kJumpVel = 11.0f;
+constexpr float kGroundY = 1.2f;  // Player center height when standing on PSU floor (floor underside anchored at y=0)
+constexpr int kMaxPellets = 16;
+static_assert(kShotgun.pellets <= kMaxPellets, "pellet buffers too small");
+
+// Velocity and gravity step of integratePlayer with no input, for every slot
+// whose mask byte is set. restrict parameters let the loop vectorize without
+// run-time alias checks.
+void integrateIdleMotion(uint32_t count, float dt, const uint8_t *__restrict idle, float *__restrict x,
+                         float *__restrict y, float *__restrict z, float *__restrict vx, float *__restrict vy,
+                         float *__restrict vz, uint8_t *__restrict grounded) {
+    for (uint32_t i = 0; i < count; ++i) {
+        const bool m = idle[i] != 0;
+        float nvx = vx[i];
+        float nvz = vz[i];
+        const float speed = std::sqrt(nvx * nvx + nvz * nvz);
+        const float dropped = std::max(0.0f, speed - speed * kFriction * dt);
+        const bool moving = speed > 0.0f;
+        const float friction = selectf(moving, dropped / selectf(moving, speed, 1.0f), 1.0f);
+        nvx *= friction;
+        nvz *= friction;
+        const float clamped = std::sqrt(nvx * nvx + nvz * nvz);
+        const float limit = selectf(clamped > kMaxSpeed, kMaxSpeed / clamped, 1.0f);
+        nvx *= limit;
+        nvz *= limit;
+
+        float nvy = vy[i] - kGravity * dt;
+        float ny = y[i] + nvy * dt;
+        const bool landed = ny < kGroundY;
+        const bool onGround = landed | (y[i] <= kGroundY + 0.05f);
+        ny = selectf(landed, kGroundY, ny);
+        nvy = selectf(landed, 0.0f, nvy);
+
+        x[i] = selectf(m, x[i] + nvx * dt, x[i]);
+        z[i] = selectf(m, z[i] + nvz * dt, z[i]);
+        vx[i] = selectf(m, nvx, vx[i]);
+        vz[i] = selectf(m, nvz, vz[i]);
+        y[i] = selectf(m, ny, y[i]);
+        vy[i] = selectf(m, nvy, vy[i]);
+        grounded[i] = static_cast<uint8_t>((m & onGround) | (!m & (grounded[i] != 0)));
+    }
 }
 } // namespace
 
-bool GameServer::raycastHit(const float ox, const float oy, const float oz,
-                            const float dirX, const float dirY, const float dirZ,
-                            const PlayerState &target, float maxDist, float &hitDist) const {
-    const float len = std::sqrt(dirX * dirX + dirY * dirY + dirZ * dirZ);
-    if (len < 1e-4f) return false;
-    const float inv = 1.0f / len;
-    const float dx = dirX * inv;
-    const float dy = dirY * inv;
-    const float dz = dirZ * inv;
-    return raySphereIntersect(ox, oy, oz, dx, dy, dz,
-                              target.x, target.y, target.z, 0.6f, maxDist, hitDist);
+void GameServer::processInput(const InputPacket &packet, float dt) {
+    const uint32_t slot = admitPlayer(packet);
+    if (slot == kNoSlot) return;
+    players_.info[slot].lastInputTick = tickCount_.load();
+    applyInput(slot, packet, dt);
 }
 
-void GameServer::processInput(const InputPacket &packet, float dt, std::vector<uint32_t> &touchedIds) {
-    PlayerState *player = findPlayer(packet.playerId);
-    if (!player) {
-        if (players_.size() >= config_.maxPlayers) return;
-        PlayerState newP{};
-        newP.id = packet.playerId;
-        newP.health = 100;
-        newP.yaw = packet.yaw;
-        newP.pitch = packet.pitch;
-        newP.active = true;
-        newP.lastSeq = packet.seq;
-        newP.lastInputTick = tickCount_.load();
-        newP.weapon = 0;
-        newP.isBot = false;
-        respawnPlayer(newP);
-        players_.push_back(newP);
-        player = &players_.back();
-    }
-
-    if (!player->active && tickCount_.load() >= player->respawnTick) {
-        respawnPlayer(*player);
-    }
-
-    if (!player->active) {
-        player->lastSeq = packet.seq;
-        player->lastInputTick = tickCount_.load();
+void GameServer::queueInput(const InputPacket &packet) {
+    if (recorder_.isOpen()) recorder_.input(packet);
+    const uint32_t slot = admitPlayer(packet);
+    if (slot == kNoSlot) return;
+    // Arrival, not consumption, keeps a buffered player from timing out.
+    players_.info[slot].lastInputTick = tickCount_.load();
+    inputQueues_[slot].push(packet);
+}
+
+void GameServer::consumeInputs(float dt) {
+    InputPacket cmd;
+    for (uint32_t i = 0; i < players_.size(); ++i) {
+        if (inputQueues_[i].pop(cmd)) applyInput(i, cmd, dt);
+    }
+}
+
+// Slot for the packet's player, joining it if there is room. Acks are taken
+// on arrival so buffering does not delay snapshot deltas.
+uint32_t GameServer::admitPlayer(const InputPacket &packet) {
+    uint32_t slot = findPlayer(packet.playerId);
+    if (slot == kNoSlot) {
+        if (players_.size() >= config_.maxPlayers) return kNoSlot;
+        slot = addPlayer(packet.playerId, false);
+        players_.health[slot] = 100;
+        players_.yaw[slot] = packet.yaw;
+        players_.pitch[slot] = packet.pitch;
+        players_.active[slot] = 1;
+        players_.info[slot].lastSeq = packet.seq;
+        players_.info[slot].lastInputTick = tickCount_.load();
+        respawnPlayer(slot);
+    }
+    PlayerInfo &info = players_.info[slot];
+    if (packet.ackTick > info.ackTick) info.ackTick = packet.ackTick;
+    return slot;
+}
+
+void GameServer::applyInput(uint32_t slot, const InputPacket &packet, float dt) {
+    PlayerInfo &info = players_.info[slot];
+
+    if (!players_.active[slot] && tickCount_.load() >= info.respawnTick) {
+        respawnPlayer(slot);
+    }
+
+    if (!players_.active[slot]) {
+        info.lastSeq = packet.seq;
         return;
     }
 
-    player->weapon = 0;
-    integratePlayer(*player, packet, dt);
-    player->lastSeq = packet.seq;
-    player->lastInputTick = tickCount_.load();
-    touchedIds.push_back(player->id);
+    info.weapon = 0;
+    integratePlayer(slot, packet, dt);
+    info.lastSeq = packet.seq;
+    players_.simTick[slot] = tickCount_.load();
 
     const uint32_t currentTick = tickCount_.load();
     const GunDef &gun = kShotgun;
-    if (packet.fire && currentTick - player->lastFireTick >= gun.cooldownTicks) {
-        player->lastFireTick = currentTick;
-        static thread_local std::mt19937 rng{std::random_device{}()};
+    if (packet.fire && currentTick - info.lastFireTick >= gun.cooldownTicks) {
+        info.lastFireTick = currentTick;
         std::uniform_real_distribution<float> jitter(-gun.spread, gun.spread);
-        for (auto &target : players_) {
-            if (!target.active || target.id == player->id || target.health <= 0) continue;
-            float totalDamage = 0.0f;
-            for (int pellet = 0; pellet < gun.pellets; ++pellet) {
-                const float yawOffset = jitter(rng);
-                const float pitchOffset = jitter(rng) * 0.6f;
-                const float yaw = player->yaw + yawOffset;
-                const float pitch = player->pitch + pitchOffset;
-                const float dirX = -std::sin(yaw) * std::cos(pitch);
-                const float dirY = std::sin(pitch);
-                const float dirZ = -std::cos(yaw) * std::cos(pitch);
-                float hitDist = 0.0f;
-                if (raycastHit(player->x, player->y, player->z, dirX, dirY, dirZ, target, gun.range, hitDist)) {
-                    const float t = clampf(1.0f - (hitDist / gun.range), 0.0f, 1.0f);
-                    const float pelletMax = gun.maxDamage / static_cast<float>(gun.pellets);
-                    const float pelletMin = gun.minDamage / static_cast<float>(gun.pellets);
-                    totalDamage += pelletMin + t * (pelletMax - pelletMin);
+        const float pelletMax = gun.maxDamage / static_cast<float>(gun.pellets);
+        const float pelletMin = gun.minDamage / static_cast<float>(gun.pellets);
+        const float ox = players_.x[slot];
+        const float oy = players_.y[slot];
+        const float oz = players_.z[slot];
+        std::array<float, kMaxPellets> yaw{}, pitch{}, sinYaw{}, cosYaw{}, sinPitch{}, cosPitch{};
+        std::array<float, kMaxPellets> dirX{}, dirY{}, dirZ{}, reach{};
+        std::array<PelletHit, kMaxPellets> hits{};
+        // Lag compensation: targets are placed where the shooter saw them, in
+        // the snapshot it last acked, at most maxRewindTicks back.
+        const uint32_t rewind = std::min({config_.maxRewindTicks, PositionHistory::kDepth - 1, currentTick});
+        const uint32_t seenTick = std::max(info.ackTick, currentTick - rewind);
+        const bool rewound = rewind > 0 && info.ackTick != 0 && seenTick <= currentTick;
+        // Since then a target has moved at most kMaxSpeed per tick, plus wall push-out.
+        const float pad =
+            kHitRadius + (rewound ? static_cast<float>(currentTick - seenTick) * dt * kMaxSpeed + 0.5f : 0.0f);
+        for (int pellet = 0; pellet < gun.pellets; ++pellet) {
+            yaw[pellet] = players_.yaw[slot] + jitter(rng_);
+            pitch[pellet] = players_.pitch[slot] + jitter(rng_) * 0.6f;
+        }
+        const size_t pellets = static_cast<size_t>(gun.pellets);
+        fastSinCos(yaw.data(), sinYaw.data(), cosYaw.data(), pellets);
+        fastSinCos(pitch.data(), sinPitch.data(), cosPitch.data(), pellets);
+        shotTargets_.clear();
+        for (int pellet = 0; pellet < gun.pellets; ++pellet) {
+            dirX[pellet] = -sinYaw[pellet] * cosPitch[pellet];
+            dirY[pellet] = sinPitch[pellet];
+            dirZ[pellet] = -cosYaw[pellet] * cosPitch[pellet];
+            // Pellets stop at walls and platforms.
+            reach[pellet] = staticRayDistance(ox, oy, oz, dirX[pellet], dirY[pellet], dirZ[pellet], gun.range);
+            // Only players in grid cells along some pellet's path can be hit.
+            grid_.traceRay(ox, oz, dirX[pellet], dirZ[pellet], reach[pellet], pad, [&](uint32_t idx, float) {
+                if (idx == slot || !players_.active[idx] || players_.health[idx] <= 0) return true;
+                if (std::find(shotTargets_.index.begin(), shotTargets_.index.end(), idx) == shotTargets_.index.end()) {
+                    float tx = players_.x[idx], ty = players_.y[idx], tz = players_.z[idx];
+                    // Not recorded then: it has (re)spawned since, so the shooter never saw it.
+                    if (rewound && !positions_.at(idx, seenTick, tx, ty, tz)) return true;
+                    shotTargets_.push(idx, tx, ty, tz);
                 }
+                return true;
+            });
+        }
+        nearestPelletHits(ox, oy, oz, dirX.data(), dirY.data(), dirZ.data(), gun.pellets, shotTargets_, kHitRadius,
+                          gun.range, hits.data());
+
+        shotHits_.clear();
+        for (int pellet = 0; pellet < gun.pellets; ++pellet) {
+            // The nearest player is past the pellet's wall, so all of them are.
+            if (hits[pellet].target == kPelletMiss || hits[pellet].dist > reach[pellet]) continue;
+            const uint32_t idx = shotTargets_.index[static_cast<size_t>(hits[pellet].target)];
+            const float t = clampf(1.0f - (hits[pellet].dist / gun.range), 0.0f, 1.0f);
+            const float damage = pelletMin + t * (pelletMax - pelletMin);
+            auto it = std::find_if(shotHits_.begin(), shotHits_.end(),
+                                   [idx](const std::pair<uint32_t, float> &h) { return h.first == idx; });
+            if (it != shotHits_.end()) {
+                it->second += damage;
+            } else {
+                shotHits_.emplace_back(idx, damage);
             }
-            if (totalDamage > 0.0f) {
-                target.health -= static_cast<int32_t>(std::round(totalDamage));
-                target.health = std::max(0, target.health);
-                if (target.health <= 0) {
-                    target.active = false;
-                    target.respawnTick = tickCount_.load() + 180;
-                }
+        }
+        for (const auto &hit : shotHits_) {
+            const uint32_t target = hit.first;
+            int32_t &health = players_.health[target];
+            health -= static_cast<int32_t>(std::round(hit.second));
+            health = std::max(0, health);
+            if (health <= 0) {
+                players_.active[target] = 0;
+                players_.info[target].respawnTick = tickCount_.load() + 180;
             }
         }
     }
 }
 
-void GameServer::integratePlayer(PlayerState &p, const InputPacket &input, float dt) {
+void GameServer::integratePlayer(uint32_t slot, const InputPacket &input, float dt) {
     const float wishX = input.moveX;
     const float wishZ = input.moveZ;
     float forwardX = -std::sin(input.yaw);
@@ -140,96 +209,130 @@ void GameServer::integratePlayer(PlayerState &p, const InputPacket &input, float
         moveDirX /= len;
         moveDirZ /= len;
     }
-    const float accel = 50.0f;
-    const float maxSpeed = 12.0f;
-    p.vx += moveDirX * accel * dt;
-    p.vz += moveDirZ * accel * dt;
+    // Work on locals: the arrays are all float, so writes through references
+    // into them would force reloads after every store.
+    float x = players_.x[slot];
+    float y = players_.y[slot];
+    float z = players_.z[slot];
+    const float fromX = x;
+    const float fromZ = z;
+    float vx = players_.vx[slot];
+    float vy = players_.vy[slot];
+    float vz = players_.vz[slot];
+    vx += moveDirX * kAccel * dt;
+    vz += moveDirZ * kAccel * dt;
 
-    const float speed = std::sqrt(p.vx * p.vx + p.vz * p.vz);
+    const float speed = std::sqrt(vx * vx + vz * vz);
     if (speed > 0.0f) {
-        const float drop = speed * 8.0f * dt;
+        const float drop = speed * kFriction * dt;
         const float newSpeed = std::max(0.0f, speed - drop);
         if (newSpeed != speed) {
             const float scale = newSpeed / speed;
-            p.vx *= scale;
-            p.vz *= scale;
+            vx *= scale;
+            vz *= scale;
         }
     }
 
-    const float newSpeed = std::sqrt(p.vx * p.vx + p.vz * p.vz);
-    if (newSpeed > maxSpeed) {
-        const float scale = maxSpeed / newSpeed;
-        p.vx *= scale;
-        p.vz *= scale;
+    const float newSpeed = std::sqrt(vx * vx + vz * vz);
+    if (newSpeed > kMaxSpeed) {
+        const float scale = kMaxSpeed / newSpeed;
+        vx *= scale;
+        vz *= scale;
     }
 
-    p.x += p.vx * dt;
-    p.z += p.vz * dt;
+    x += vx * dt;
+    z += vz * dt;
 
-    const float gravity = 26.0f;
-    const float jumpVel = 11.0f;
-    const float groundY = 1.2f;  // Player center height when standing on PSU floor (floor underside anchored at y=0)
-    bool onGround = p.y <= groundY + 0.05f;
+    bool onGround = y <= kGroundY + 0.05f;
     if (input.jump && onGround) {
-        p.vy = jumpVel;
+        vy = kJumpVel;
         onGround = false;
     }
-    p.vy -= gravity * dt;
-    p.y += p.vy * dt;
-    if (p.y < groundY) {
-        p.y = groundY;
-        p.vy = 0.0f;
+    vy -= kGravity * dt;
+    y += vy * dt;
+    if (y < kGroundY) {
+        y = kGroundY;
+        vy = 0.0f;
         onGround = true;
     }
-    p.grounded = onGround;
+    players_.x[slot] = x;
+    players_.y[slot] = y;
+    players_.z[slot] = z;
+    players_.vx[slot] = vx;
+    players_.vy[slot] = vy;
+    players_.vz[slot] = vz;
+    players_.grounded[slot] = onGround ? 1 : 0;
 
-    resolveWalls(p);
-    resolvePlatforms(p);
+    resolveWalls(slot, fromX, fromZ);
+    resolvePlatforms(slot, slot + 1, players_.active.data(), dt);
 
     const float half = config_.worldHalfExtent;
-    p.x = clampf(p.x, -half, half);
-    p.z = clampf(p.z, -half, half);
+    players_.x[slot] = clampf(players_.x[slot], -half, half);
+    players_.z[slot] = clampf(players_.z[slot], -half, half);
 
-    p.yaw = input.yaw;
-    p.pitch = input.pitch;
+    players_.yaw[slot] = input.yaw;
+    players_.pitch[slot] = input.pitch;
+    grid_.update(slot, players_.x[slot], players_.z[slot]);
 }
 
-void GameServer::respawnPlayer(PlayerState &p) {
-    static std::mt19937 rng{std::random_device{}()};
+// integratePlayer with no input for every slot flagged in idle_, done as
+// passes over whole arrays. Results match the per-player path.
+void GameServer::integrateIdle(float dt) {
+    const uint32_t count = static_cast<uint32_t>(players_.size());
+    const uint8_t *idle = idle_.data();
+    moveFromX_.assign(players_.x.begin(), players_.x.end());
+    moveFromZ_.assign(players_.z.begin(), players_.z.end());
+    integrateIdleMotion(count, dt, idle, players_.x.data(), players_.y.data(), players_.z.data(), players_.vx.data(),
+                        players_.vy.data(), players_.vz.data(), players_.grounded.data());
+
+    resolveWalls(0, count, idle, moveFromX_.data(), moveFromZ_.data());
+    resolvePlatforms(0, count, idle, dt);
+
+    const float half = config_.worldHalfExtent;
+    float *x = players_.x.data();
+    float *z = players_.z.data();
+    for (uint32_t i = 0; i < count; ++i) {
+        const bool m = idle[i] != 0;
+        x[i] = selectf(m, clampf(x[i], -half, half), x[i]);
+        z[i] = selectf(m, clampf(z[i], -half, half), z[i]);
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        if (idle[i]) grid_.update(i, x[i], z[i]);
+    }
+}
+
+void GameServer::respawnPlayer(uint32_t slot) {
+    positions_.restart(slot, tickCount_.load() + 1);
     std::uniform_real_distribution<float> jitter(-1.2f, 1.2f);
+    float &x = players_.x[slot];
+    float &z = players_.z[slot];
     bool placed = false;
-    for (int attempt = 0; attempt < 12; ++attempt) {
-        const auto &base = kSpawnPoints[static_cast<size_t>(rng() % kSpawnPoints.size())];
-        p.x = base.first + jitter(rng);
-        p.z = base.second + jitter(rng);
-        bool bad = false;
-        for (const auto &w : walls_) {
-            if (overlapsWall(p, w)) { bad = true; break; }
-        }
-        if (!bad) { placed = true; break; }
+    for (int attempt = 0; attempt < 12 && !spawns_.empty(); ++attempt) {
+        const SpawnPoint &base = spawns_[static_cast<size_t>(rng_() % spawns_.size())];
+        x = base.x + jitter(rng_);
+        z = base.z + jitter(rng_);
+        if (!blockedByWall(x, z)) { placed = true; break; }
     }
     if (!placed) {
         std::uniform_real_distribution<float> dist(-config_.worldHalfExtent + 1.5f, config_.worldHalfExtent - 1.5f);
         for (int attempt = 0; attempt < 20; ++attempt) {
-            p.x = dist(rng);
-            p.z = dist(rng);
-            bool bad = false;
-            for (const auto &w : walls_) {
-                if (overlapsWall(p, w)) { bad = true; break; }
-            }
-            if (!bad) { placed = true; break; }
+            x = dist(rng_);
+            z = dist(rng_);
+            if (!blockedByWall(x, z)) { placed = true; break; }
         }
     }
     if (!placed) {
-        p.x = 0.0f;
-        p.z = 0.0f;
-    }
-    p.y = 10.0f;  // Spawn well above to find actual floor height
-    p.vx = p.vy = p.vz = 0.0f;
-    p.health = 100;
-    p.active = true;
-    p.lastFireTick = 0;
-    p.lastInputTick = tickCount_.load();
-    p.weapon = 0;
-    p.grounded = false;  // Will fall and land on ground
+        x = 0.0f;
+        z = 0.0f;
+    }
+    players_.y[slot] = 10.0f;  // Spawn well above to find actual floor height
+    players_.vx[slot] = players_.vy[slot] = players_.vz[slot] = 0.0f;
+    players_.health[slot] = 100;
+    players_.active[slot] = 1;
+    players_.grounded[slot] = 0;  // Will fall and land on ground
+    PlayerInfo &info = players_.info[slot];
+    info.lastFireTick = 0;
+    info.lastInputTick = tickCount_.load();
+    info.weapon = 0;
+    grid_.update(slot, x, z);
 }
@@ -2,10 +2,37 @@
 #include "game_math.h"
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace {
+// Safe spawn anchors roughly centered in rooms/corridors to avoid wall overlaps.
+constexpr std::array<SpawnPoint, 8> kSpawnPoints{{
+    {-5.0f, -5.0f},
+    {5.0f, -5.0f},
+    {-5.0f, 5.0f},
+    {5.0f, 5.0f},
+    {0.0f, -6.0f},
+    {0.0f, 6.0f},
+    {-8.0f, 0.0f},
+    {8.0f, 0.0f},
+}};
+} // namespace
 
 void GameServer::setupMap() {
+    spiders_.clear();
+    map_.reset();
+    if (!config_.mapPath.empty()) {
+        if (std::shared_ptr<const MapFile> map = MapFile::open(config_.mapPath)) {
+            loadMap(*map);
+            map_ = std::move(map);
+            return;
+        }
+    }
     walls_.clear();
     platforms_.clear();
+    spawns_.assign(kSpawnPoints.begin(), kSpawnPoints.end());
     const float h = config_.worldHalfExtent;
     walls_.push_back({-h, h, h - 1.0f, h});
     walls_.push_back({-h, h, -h, -h + 1.0f});
@@ -19,102 +46,405 @@ void GameServer::setupMap() {
     };
     // No platforms for collider simplicity
 
-    spiders_.clear();
+    buildColliders();
 }
 
-bool GameServer::overlapsWall(const PlayerState &p, const Wall &w) const {
+bool GameServer::overlapsWall(float x, float z, const Wall &w) const {
     const float r = playerRadius_;
-    return (p.x + r > w.minX && p.x - r < w.maxX && p.z + r > w.minZ && p.z - r < w.maxZ);
-}
-
-void GameServer::resolveWalls(PlayerState &p) {
-    for (const auto &w : walls_) {
-        if (!overlapsWall(p, w)) continue;
-        const float r = playerRadius_;
-        const float penLeft = (w.maxX - (p.x - r));
-        const float penRight = ((p.x + r) - w.minX);
-        const float penDown = ((p.z + r) - w.minZ);
-        const float penUp = (w.maxZ - (p.z - r));
-        float minPen = penLeft;
-        int axis = 0;
-        if (penRight < minPen) { minPen = penRight; axis = 1; }
-        if (penDown < minPen) { minPen = penDown; axis = 2; }
-        if (penUp < minPen) { minPen = penUp; axis = 3; }
-        switch (axis) {
-            case 0: p.x = w.maxX + r; p.vx = 0.0f; break;
-            case 1: p.x = w.minX - r; p.vx = 0.0f; break;
-            case 2: p.z = w.minZ - r; p.vz = 0.0f; break;
-            case 3: p.z = w.maxZ + r; p.vz = 0.0f; break;
+    return (x + r > w.minX && x - r < w.maxX && z + r > w.minZ && z - r < w.maxZ);
+}
+
+namespace {
+constexpr size_t kGridMinColliders = 16;
+constexpr float kColliderCell = 4.0f;
+constexpr float kColliderSlack = 0.5f;
+constexpr int kMaxSlides = 3; // walls a move can be stopped by; the rest of it is dropped
+// A platform's height is the center height of a player standing on it,
+// kGroundY (game_server_players.cc) above its surface, so the solid part
+// stops that far below.
+constexpr float kStandHeight = 1.2f;
+
+// One wall plus the positions a circle of radius r gets pushed to on each side.
+struct WallPush {
+    float minX, maxX, minZ, maxZ;
+    float toMinX, toMaxX, toMinZ, toMaxZ;
+    float r;
+};
+
+WallPush wallPush(const Wall &w, float r) {
+    return {w.minX, w.maxX, w.minZ, w.maxZ, w.minX - r, w.maxX + r, w.minZ - r, w.maxZ + r, r};
+}
+
+// Pushes a circle out of the wall along the axis of least penetration (ties
+// prefer x, then -x/-z). Branch-free so loops over players vectorize.
+inline void pushOutOfWall(const WallPush &w, bool enabled, float &x, float &z, float &vx, float &vz) {
+    const float r = w.r;
+    const bool hit = enabled & (x + r > w.minX) & (x - r < w.maxX) & (z + r > w.minZ) & (z - r < w.maxZ);
+    const float penLeft = (w.maxX - (x - r));
+    const float penRight = ((x + r) - w.minX);
+    const float penDown = ((z + r) - w.minZ);
+    const float penUp = (w.maxZ - (z - r));
+    const bool right = penRight < penLeft;
+    const bool up = penUp < penDown;
+    // min(penDown, penUp) < min(penLeft, penRight)
+    const bool alongZ = ((penDown < penLeft) & (penDown < penRight)) | ((penUp < penLeft) & (penUp < penRight));
+    const bool moveX = hit & !alongZ;
+    const bool moveZ = hit & alongZ;
+    x = selectf(moveX, selectf(right, w.toMinX, w.toMaxX), x);
+    vx = selectf(moveX, 0.0f, vx);
+    z = selectf(moveZ, selectf(up, w.toMaxZ, w.toMinZ), z);
+    vz = selectf(moveZ, 0.0f, vz);
+}
+
+void pushOutOfWall(const WallPush &w, uint32_t begin, uint32_t end, const uint8_t *__restrict mask,
+                   float *__restrict x, float *__restrict z, float *__restrict vx, float *__restrict vz) {
+    for (uint32_t i = begin; i < end; ++i) pushOutOfWall(w, mask[i] != 0, x[i], z[i], vx[i], vz[i]);
+}
+
+// Player state the platform pass reads and writes.
+struct Body {
+    float x, y, z, vx, vy, vz;
+    uint8_t grounded;
+};
+
+// Lands a player on the platform or pushes it out of the side.
+void collidePlatform(const Platform &pl, float r, Body &b) {
+    const bool insideXZ = (b.x + r > pl.minX && b.x - r < pl.maxX && b.z + r > pl.minZ && b.z - r < pl.maxZ);
+    if (!insideXZ) return;
+    const float top = pl.height;
+    if (b.vy < 0.0f && b.y <= top + 0.2f && b.y >= top - 0.8f) {
+        b.y = top;
+        b.vy = 0.0f;
+        b.grounded = 1;
+    }
+    if (b.y > top + 0.2f) return;
+    const float penLeft = (pl.maxX - (b.x - r));
+    const float penRight = ((b.x + r) - pl.minX);
+    const float penDown = ((b.z + r) - pl.minZ);
+    const float penUp = (pl.maxZ - (b.z - r));
+    float minPen = penLeft;
+    int axis = 0;
+    if (penRight < minPen) { minPen = penRight; axis = 1; }
+    if (penDown < minPen) { minPen = penDown; axis = 2; }
+    if (penUp < minPen) { minPen = penUp; axis = 3; }
+    switch (axis) {
+        case 0: b.x = pl.maxX + r; b.vx = 0.0f; break;
+        case 1: b.x = pl.minX - r; b.vx = 0.0f; break;
+        case 2: b.z = pl.minZ - r; b.vz = 0.0f; break;
+        case 3: b.z = pl.maxZ + r; b.vz = 0.0f; break;
+    }
+}
+
+// Spider push-out: along the shallower axis, away from the wall's center.
+void pushSpiderOut(const Wall &w, float r, float &x, float &z) {
+    if (!(x + r > w.minX && x - r < w.maxX && z + r > w.minZ && z - r < w.maxZ)) return;
+    const float overlapX = std::min(x + r - w.minX, w.maxX - (x - r));
+    const float overlapZ = std::min(z + r - w.minZ, w.maxZ - (z - r));
+    if (overlapX < overlapZ) {
+        if (x < (w.minX + w.maxX) / 2.0f) {
+            x = w.minX - r - 0.01f;
+        } else {
+            x = w.maxX + r + 0.01f;
+        }
+    } else {
+        if (z < (w.minZ + w.maxZ) / 2.0f) {
+            z = w.minZ - r - 0.01f;
+        } else {
+            z = w.maxZ + r + 0.01f;
         }
     }
 }
 
-void GameServer::resolvePlatforms(PlayerState &p) {
-    for (const auto &pl : platforms_) {
-        const bool insideXZ = (p.x + playerRadius_ > pl.minX && p.x - playerRadius_ < pl.maxX &&
-                               p.z + playerRadius_ > pl.minZ && p.z - playerRadius_ < pl.maxZ);
-        if (!insideXZ) continue;
-        const float top = pl.height;
-        if (p.vy < 0.0f && p.y <= top + 0.2f && p.y >= top - 0.8f) {
-            p.y = top;
-            p.vy = 0.0f;
-            p.grounded = true;
+// Half the width of the thinnest wall.
+float minHalfWidth(const std::vector<Wall> &walls) {
+    float half = std::numeric_limits<float>::infinity();
+    for (const Wall &w : walls) half = std::min(half, 0.5f * std::min(w.maxX - w.minX, w.maxZ - w.minZ));
+    return half;
+}
+
+// When a box of half-size r moving by (mx, mz) from (x, z) first touches the
+// wall, if before toi; alongX says it hit an x face. Starting inside the wall
+// or grazing it is no hit; the push-out pass handles those.
+inline bool sweepWall(const Wall &w, float r, float x, float z, float mx, float mz, float &toi, bool &alongX) {
+    const float inf = std::numeric_limits<float>::infinity();
+    float enterX = -inf, exitX = inf, enterZ = -inf, exitZ = inf;
+    if (mx != 0.0f) {
+        enterX = ((mx > 0.0f ? w.minX - r : w.maxX + r) - x) / mx;
+        exitX = ((mx > 0.0f ? w.maxX + r : w.minX - r) - x) / mx;
+    } else if (!(x > w.minX - r && x < w.maxX + r)) {
+        return false;
+    }
+    if (mz != 0.0f) {
+        enterZ = ((mz > 0.0f ? w.minZ - r : w.maxZ + r) - z) / mz;
+        exitZ = ((mz > 0.0f ? w.maxZ + r : w.minZ - r) - z) / mz;
+    } else if (!(z > w.minZ - r && z < w.maxZ + r)) {
+        return false;
+    }
+    const float enter = std::max(enterX, enterZ);
+    if (enter < 0.0f || enter >= toi || enter >= std::min(exitX, exitZ)) return false;
+    toi = enter;
+    alongX = enterX >= enterZ;
+    return true;
+}
+
+// Clips [tMin, tMax] to where o + d*t lies within [lo, hi] on one axis.
+inline bool clipSlab(float o, float d, float lo, float hi, float &tMin, float &tMax) {
+    if (d == 0.0f) return o >= lo && o <= hi;
+    const float inv = 1.0f / d;
+    float t0 = (lo - o) * inv;
+    float t1 = (hi - o) * inv;
+    if (t0 > t1) std::swap(t0, t1);
+    tMin = std::max(tMin, t0);
+    tMax = std::min(tMax, t1);
+    return tMin <= tMax;
+}
+
+// Where a unit ray enters the box (walls are unbounded in y), or maxDist if
+// it misses it within maxDist. A box the ray starts inside doesn't block it.
+inline float rayEnters(float ox, float oy, float oz, float dx, float dy, float dz, float minX, float maxX, float minY,
+                       float maxY, float minZ, float maxZ, float maxDist) {
+    float tMin = -std::numeric_limits<float>::infinity();
+    float tMax = maxDist;
+    if (!clipSlab(ox, dx, minX, maxX, tMin, tMax) || !clipSlab(oz, dz, minZ, maxZ, tMin, tMax) ||
+        !clipSlab(oy, dy, minY, maxY, tMin, tMax)) {
+        return maxDist;
+    }
+    return tMin >= 0.0f ? tMin : maxDist;
+}
+
+// Swept bounds around a circle moving from (fromX, fromZ) to (x, z), with some
+// slack so small pushes stay inside.
+ColliderBounds sweptBounds(float fromX, float fromZ, float x, float z, float r) {
+    const float pad = r + kColliderSlack;
+    return {std::min(fromX, x) - pad, std::max(fromX, x) + pad, std::min(fromZ, z) - pad, std::max(fromZ, z) + pad,
+            r};
+}
+} // namespace
+
+// Copies the (small) geometry and uses the baked grids where they are in place.
+void GameServer::loadMap(const MapFile &map) {
+    config_.worldHalfExtent = map.worldHalfExtent();
+    walls_.assign(map.walls(), map.walls() + map.wallCount());
+    platforms_.assign(map.platforms(), map.platforms() + map.platformCount());
+    spawns_.assign(map.spawns(), map.spawns() + map.spawnCount());
+    minWallHalfWidth_ = minHalfWidth(walls_);
+    if (walls_.size() > kGridMinColliders) {
+        wallGrid_.attach(&map.walls()->minX, sizeof(Wall) / sizeof(float), map.wallCount(), map.worldHalfExtent(),
+                         map.cellSize(), map.wallCells(), map.wallItems());
+    } else {
+        wallGrid_.clear();
+    }
+    if (platforms_.size() > kGridMinColliders) {
+        platformGrid_.attach(&map.platforms()->minX, sizeof(Platform) / sizeof(float), map.platformCount(),
+                             map.worldHalfExtent(), map.cellSize(), map.platformCells(), map.platformItems());
+    } else {
+        platformGrid_.clear();
+    }
+}
+
+void GameServer::buildColliders() {
+    minWallHalfWidth_ = minHalfWidth(walls_);
+    // A handful of colliders is faster to loop over (and the wall pass vectorizes).
+    if (walls_.size() > kGridMinColliders) {
+        wallGrid_.build(walls_, config_.worldHalfExtent, kColliderCell);
+    } else {
+        wallGrid_.clear();
+    }
+    if (platforms_.size() > kGridMinColliders) {
+        platformGrid_.build(platforms_, config_.worldHalfExtent, kColliderCell);
+    } else {
+        platformGrid_.clear();
+    }
+}
+
+bool GameServer::blockedByWall(float x, float z) const {
+    if (wallGrid_.empty()) {
+        for (const auto &w : walls_) {
+            if (overlapsWall(x, z, w)) return true;
+        }
+        return false;
+    }
+    const float r = playerRadius_;
+    bool blocked = false;
+    wallGrid_.forEach(x - r, x + r, z - r, z + r, [&](uint32_t i) {
+        blocked = overlapsWall(x, z, walls_[i]);
+        return !blocked;
+    });
+    return blocked;
+}
+
+// Runs collide(i) for the colliders a circle of radius r at (x, z) may touch,
+// in index order, with the same outcome as running it for all count of
+// them; collide may move the circle. The grid is queried around the swept
+// bounds and again wherever a push carries the circle out of them.
+template <typename Collide>
+void GameServer::collideInOrder(const ColliderGrid &grid, size_t count, float r, float fromX, float fromZ,
+                                const float &x, const float &z, Collide &&collide) {
+    if (grid.empty()) {
+        for (uint32_t i = 0; i < count; ++i) collide(i);
+        return;
+    }
+    ColliderBounds bounds = sweptBounds(fromX, fromZ, x, z, r);
+    grid.query(bounds.minX, bounds.maxX, bounds.minZ, bounds.maxZ, colliderHits_);
+    for (size_t k = 0; k < colliderHits_.size(); ++k) {
+        const uint32_t i = colliderHits_[k];
+        collide(i);
+        if (bounds.contains(x, z)) continue;
+        // Colliders before i were tested while the circle was inside the old
+        // bounds, so only later ones can have come into reach.
+        bounds = sweptBounds(x, z, x, z, r);
+        grid.query(bounds.minX, bounds.maxX, bounds.minZ, bounds.maxZ, colliderHits_);
+        k = static_cast<size_t>(std::upper_bound(colliderHits_.begin(), colliderHits_.end(), i) - colliderHits_.begin());
+        --k;
+    }
+}
+
+// Moves short enough that no wall can be crossed are left to the push-out
+// pass; at 60 Hz that is every move on the current maps.
+void GameServer::sweepWalls(float r, float fromX, float fromZ, float &x, float &z, float &vx, float &vz) {
+    float mx = x - fromX;
+    float mz = z - fromZ;
+    if (std::max(std::fabs(mx), std::fabs(mz)) < minWallHalfWidth_ + r) return;
+    // Sliding only shortens the move, so it stays within the first query.
+    const bool grid = !wallGrid_.empty();
+    if (grid) {
+        const ColliderBounds bounds = sweptBounds(fromX, fromZ, x, z, r);
+        wallGrid_.query(bounds.minX, bounds.maxX, bounds.minZ, bounds.maxZ, colliderHits_);
+    }
+    const size_t count = grid ? colliderHits_.size() : walls_.size();
+    float px = fromX;
+    float pz = fromZ;
+    for (int slide = 0; slide < kMaxSlides; ++slide) {
+        float toi = 1.0f;
+        bool alongX = false;
+        const Wall *hit = nullptr;
+        for (size_t k = 0; k < count; ++k) {
+            const Wall &w = walls_[grid ? colliderHits_[k] : k];
+            if (sweepWall(w, r, px, pz, mx, mz, toi, alongX)) hit = &w;
+        }
+        if (!hit) {
+            px += mx;
+            pz += mz;
+            break;
         }
-        if (p.y > top + 0.2f) continue;
-        const float penLeft = (pl.maxX - (p.x - playerRadius_));
-        const float penRight = ((p.x + playerRadius_) - pl.minX);
-        const float penDown = ((p.z + playerRadius_) - pl.minZ);
-        const float penUp = (pl.maxZ - (p.z - playerRadius_));
-        float minPen = penLeft;
-        int axis = 0;
-        if (penRight < minPen) { minPen = penRight; axis = 1; }
-        if (penDown < minPen) { minPen = penDown; axis = 2; }
-        if (penUp < minPen) { minPen = penUp; axis = 3; }
-        switch (axis) {
-            case 0: p.x = pl.maxX + playerRadius_; p.vx = 0.0f; break;
-            case 1: p.x = pl.minX - playerRadius_; p.vx = 0.0f; break;
-            case 2: p.z = pl.minZ - playerRadius_; p.vz = 0.0f; break;
-            case 3: p.z = pl.maxZ + playerRadius_; p.vz = 0.0f; break;
+        // Stop against the wall and keep the motion along it.
+        if (alongX) {
+            px = mx > 0.0f ? hit->minX - r : hit->maxX + r;
+            pz += mz * toi;
+            mx = 0.0f;
+            mz *= 1.0f - toi;
+            vx = 0.0f;
+        } else {
+            pz = mz > 0.0f ? hit->minZ - r : hit->maxZ + r;
+            px += mx * toi;
+            mz = 0.0f;
+            mx *= 1.0f - toi;
+            vz = 0.0f;
         }
     }
+    x = px;
+    z = pz;
 }
 
-void GameServer::resolveSpiderWalls(SpiderEntity &spider) {
-    const float r = spiderRadius_;
-    for (const auto &w : walls_) {
-        if (spider.x + r > w.minX && spider.x - r < w.maxX &&
-            spider.z + r > w.minZ && spider.z - r < w.maxZ) {
-            const float overlapX = std::min(spider.x + r - w.minX, w.maxX - (spider.x - r));
-            const float overlapZ = std::min(spider.z + r - w.minZ, w.maxZ - (spider.z - r));
-            if (overlapX < overlapZ) {
-                if (spider.x < (w.minX + w.maxX) / 2.0f) {
-                    spider.x = w.minX - r - 0.01f;
-                } else {
-                    spider.x = w.maxX + r + 0.01f;
-                }
-            } else {
-                if (spider.z < (w.minZ + w.maxZ) / 2.0f) {
-                    spider.z = w.minZ - r - 0.01f;
-                } else {
-                    spider.z = w.maxZ + r + 0.01f;
-                }
-            }
+void GameServer::pushOutOfWalls(float fromX, float fromZ, float &x, float &z, float &vx, float &vz) {
+    const float r = playerRadius_;
+    collideInOrder(wallGrid_, walls_.size(), r, fromX, fromZ, x, z, [&](uint32_t i) {
+        if (overlapsWall(x, z, walls_[i])) pushOutOfWall(wallPush(walls_[i], r), true, x, z, vx, vz);
+    });
+}
+
+void GameServer::resolveWalls(uint32_t slot, float fromX, float fromZ) {
+    float x = players_.x[slot];
+    float z = players_.z[slot];
+    float vx = players_.vx[slot];
+    float vz = players_.vz[slot];
+    sweepWalls(playerRadius_, fromX, fromZ, x, z, vx, vz);
+    pushOutOfWalls(fromX, fromZ, x, z, vx, vz);
+    players_.x[slot] = x;
+    players_.z[slot] = z;
+    players_.vx[slot] = vx;
+    players_.vz[slot] = vz;
+}
+
+// Walls are the outer loop so the inner loop runs across players and can be
+// vectorized; each player still sees the walls in order. Past a handful of
+// walls each player instead tests the ones the grid has along its move.
+void GameServer::resolveWalls(uint32_t begin, uint32_t end, const uint8_t *mask, const float *fromX,
+                              const float *fromZ) {
+    for (uint32_t i = begin; i < end; ++i) {
+        if (!mask[i]) continue;
+        sweepWalls(playerRadius_, fromX[i], fromZ[i], players_.x[i], players_.z[i], players_.vx[i], players_.vz[i]);
+        if (!wallGrid_.empty()) {
+            pushOutOfWalls(fromX[i], fromZ[i], players_.x[i], players_.z[i], players_.vx[i], players_.vz[i]);
         }
     }
+    if (!wallGrid_.empty()) return;
+    for (const auto &wall : walls_) {
+        pushOutOfWall(wallPush(wall, playerRadius_), begin, end, mask, players_.x.data(), players_.z.data(),
+                      players_.vx.data(), players_.vz.data());
+    }
+}
+
+void GameServer::resolvePlatforms(uint32_t begin, uint32_t end, const uint8_t *mask, float dt) {
+    const float r = playerRadius_;
+    for (uint32_t i = begin; i < end; ++i) {
+        if (!mask[i]) continue;
+        Body b{players_.x[i], players_.y[i], players_.z[i], players_.vx[i], players_.vy[i], players_.vz[i],
+               players_.grounded[i]};
+        collideInOrder(platformGrid_, platforms_.size(), r, b.x - b.vx * dt, b.z - b.vz * dt, b.x, b.z,
+                       [&](uint32_t p) { collidePlatform(platforms_[p], r, b); });
+        players_.x[i] = b.x;
+        players_.y[i] = b.y;
+        players_.z[i] = b.z;
+        players_.vx[i] = b.vx;
+        players_.vy[i] = b.vy;
+        players_.vz[i] = b.vz;
+        players_.grounded[i] = b.grounded;
+    }
+}
+
+void GameServer::resolveSpiderWalls(uint32_t spider, float fromX, float fromZ) {
+    const float r = spiderRadius_;
+    float &x = spiders_.x[spider];
+    float &z = spiders_.z[spider];
+    sweepWalls(r, fromX, fromZ, x, z, spiders_.vx[spider], spiders_.vz[spider]);
+    collideInOrder(wallGrid_, walls_.size(), r, fromX, fromZ, x, z,
+                   [&](uint32_t i) { pushSpiderOut(walls_[i], r, x, z); });
+}
+
+float GameServer::staticRayDistance(float ox, float oy, float oz, float dx, float dy, float dz, float maxDist) const {
+    const float inf = std::numeric_limits<float>::infinity();
+    float nearest = maxDist;
+    auto wall = [&](uint32_t i) {
+        const Wall &w = walls_[i];
+        nearest =
+            std::min(nearest, rayEnters(ox, oy, oz, dx, dy, dz, w.minX, w.maxX, -inf, inf, w.minZ, w.maxZ, nearest));
+        return nearest;
+    };
+    auto platform = [&](uint32_t i) {
+        const Platform &p = platforms_[i];
+        nearest = std::min(nearest, rayEnters(ox, oy, oz, dx, dy, dz, p.minX, p.maxX, -inf, p.height - kStandHeight,
+                                              p.minZ, p.maxZ, nearest));
+        return nearest;
+    };
+    if (wallGrid_.empty()) {
+        for (uint32_t i = 0; i < walls_.size(); ++i) wall(i);
+    } else {
+        wallGrid_.traceRay(ox, oz, dx, dz, nearest, wall);
+    }
+    if (platformGrid_.empty()) {
+        for (uint32_t i = 0; i < platforms_.size(); ++i) platform(i);
+    } else {
+        platformGrid_.traceRay(ox, oz, dx, dz, nearest, platform);
+    }
+    return nearest;
 }
 
 void GameServer::spawnSpider(float x, float z) {
-    SpiderEntity spider{};
-    spider.id = nextSpiderId_++;
-    spider.x = x;
-    spider.y = 0.3f;
-    spider.z = z;
-    spider.vx = 0.0f;
-    spider.vz = 0.0f;
-    spider.yaw = 0.0f;
-    spider.health = 80;
-    spider.active = true;
-    spider.targetPlayerId = 0;
-    spider.lastAttackTick = 0;
-    spiders_.push_back(spider);
+    const uint32_t slot = spiders_.add(nextSpiderId_++);
+    spiders_.x[slot] = x;
+    spiders_.y[slot] = 0.3f;
+    spiders_.z[slot] = z;
+    spiders_.health[slot] = 80;
+    spiders_.active[slot] = 1;
 }
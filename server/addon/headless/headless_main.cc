@@ -0,0 +1,257 @@
+// Standalone simulation host for capacity planning: rooms of synthetic
+// clients (and bots) run without Node, then tick-time percentiles, input
+// drops and snapshot sizes are printed.
+//
+// Usage: headless [--clients N] [--bots N] [--rooms N] [--ticks N]
+//                 [--rate HZ] [--workers N] [--lag TICKS] [--loss PCT]
+//                 [--depth N] [--seed N] [--record PATH] [--map PATH]
+// --rate 0 steps one room as fast as the CPU allows; otherwise rooms run on
+// a RoomPool of --workers threads at HZ.
+#include "../room_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+struct Options {
+    uint32_t clients = 64;
+    uint32_t bots = 0;
+    uint32_t rooms = 1;
+    uint32_t ticks = 3600;
+    double rate = 60.0;
+    unsigned workers = 1;
+    uint32_t lag = 6;   // ticks between a snapshot and the client acking it
+    uint32_t loss = 0;  // percent of packets never sent
+    uint32_t depth = 1; // inputBufferDepth
+    uint32_t seed = 0;
+    std::string record;
+    std::string map;
+};
+
+bool parseOptions(int argc, char **argv, Options &o) {
+    for (int i = 1; i < argc; ++i) {
+        const char *key = argv[i];
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "missing value for %s\n", key);
+            return false;
+        }
+        const char *value = argv[++i];
+        const uint32_t n = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        if (!std::strcmp(key, "--clients")) o.clients = n;
+        else if (!std::strcmp(key, "--bots")) o.bots = n;
+        else if (!std::strcmp(key, "--rooms")) o.rooms = std::max(1u, n);
+        else if (!std::strcmp(key, "--ticks")) o.ticks = n;
+        else if (!std::strcmp(key, "--rate")) o.rate = std::strtod(value, nullptr);
+        else if (!std::strcmp(key, "--workers")) o.workers = n;
+        else if (!std::strcmp(key, "--lag")) o.lag = n;
+        else if (!std::strcmp(key, "--loss")) o.loss = std::min(100u, n);
+        else if (!std::strcmp(key, "--depth")) o.depth = n;
+        else if (!std::strcmp(key, "--seed")) o.seed = n;
+        else if (!std::strcmp(key, "--record")) o.record = value;
+        else if (!std::strcmp(key, "--map")) o.map = value;
+        else {
+            std::fprintf(stderr, "unknown option %s\n", key);
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Lcg {
+    uint32_t state;
+    uint32_t next() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+    float unit() { return static_cast<float>(next()) / static_cast<float>(1u << 24); }
+};
+
+// A player who picks a movement (strafe, run, stand) and turn rate for
+// half a second to two seconds at a time, holds the trigger in bursts and
+// jumps now and then.
+class SyntheticClient {
+public:
+    SyntheticClient(uint32_t id, uint32_t seed) : id_(id), rng_{seed * 2654435761u + id} {
+        yaw_ = rng_.unit() * 6.2831853f;
+    }
+
+    // Command for tick, or false if this one is lost on the way.
+    bool next(uint32_t tick, float dt, const Options &o, InputPacket &in) {
+        if (tick >= nextChange_) {
+            moveX_ = static_cast<float>(static_cast<int>(rng_.next() % 3) - 1);
+            moveZ_ = rng_.next() % 4 == 0 ? 0.0f : 1.0f;
+            turnRate_ = (rng_.unit() - 0.5f) * 4.0f;
+            nextChange_ = tick + 30 + rng_.next() % 90;
+        }
+        yaw_ += turnRate_ * dt;
+        if (burstLeft_ > 0) {
+            --burstLeft_;
+        } else if (rng_.next() % 90 == 0) {
+            burstLeft_ = 20 + rng_.next() % 40;
+        }
+        ++seq_;
+        in = InputPacket{};
+        in.playerId = id_;
+        in.seq = seq_;
+        in.moveX = moveX_;
+        in.moveZ = moveZ_;
+        in.yaw = yaw_;
+        in.pitch = 0.15f * std::sin(static_cast<float>(tick) * 0.05f + static_cast<float>(id_));
+        in.fire = burstLeft_ > 0;
+        in.jump = rng_.next() % 120 == 0;
+        in.ackTick = tick > o.lag ? tick - o.lag : 0;
+        return rng_.next() % 100 >= o.loss;
+    }
+
+private:
+    uint32_t id_;
+    Lcg rng_;
+    uint32_t seq_ = 0;
+    float yaw_ = 0.0f;
+    float moveX_ = 0.0f;
+    float moveZ_ = 1.0f;
+    float turnRate_ = 0.0f;
+    uint32_t nextChange_ = 0;
+    uint32_t burstLeft_ = 0;
+};
+
+std::vector<SyntheticClient> makeClients(const Options &o, uint32_t room) {
+    std::vector<SyntheticClient> clients;
+    clients.reserve(o.clients);
+    for (uint32_t c = 0; c < o.clients; ++c) clients.emplace_back(c + 1, o.seed + room * 7919u);
+    return clients;
+}
+
+void pushInputs(GameServer &server, std::vector<SyntheticClient> &clients, uint32_t tick, float dt,
+                const Options &o) {
+    InputPacket in;
+    for (SyntheticClient &client : clients) {
+        if (client.next(tick, dt, o, in)) server.pushInput(in);
+    }
+}
+
+double us(uint64_t ns) { return static_cast<double>(ns) * 1e-3; }
+
+void report(const GameServer &server, const Options &o, double tickHz, bool throttled) {
+    const TickProfiler &prof = server.profiler();
+    const LatencyHistogram &total = prof.phase(TickPhase::Total);
+    const double budgetUs = 1e6 / tickHz;
+    const double meanUs = total.count() ? us(total.sum()) / static_cast<double>(total.count()) : 0.0;
+    std::printf("  tick        mean %8.1f  p50 %8.1f  p90 %8.1f  p99 %8.1f  p99.9 %8.1f  max %8.1f us\n", meanUs,
+                us(total.percentile(0.50)), us(total.percentile(0.90)), us(total.percentile(0.99)),
+                us(total.percentile(0.999)), us(total.max()));
+    for (size_t p = 0; p < kTickPhaseCount - 1; ++p) {
+        const LatencyHistogram &h = prof.phase(static_cast<TickPhase>(p));
+        std::printf("    %-9s mean %8.1f  p99 %8.1f us\n", tickPhaseName(static_cast<TickPhase>(p)),
+                    h.count() ? us(h.sum()) / static_cast<double>(h.count()) : 0.0, us(h.percentile(0.99)));
+    }
+    if (throttled) {
+        const LatencyHistogram &lag = prof.startLag();
+        std::printf("  start lag   p50 %8.1f  p99 %8.1f  max %8.1f us, skipped ticks %llu\n", us(lag.percentile(0.50)),
+                    us(lag.percentile(0.99)), us(lag.max()), static_cast<unsigned long long>(prof.skippedTicks()));
+    }
+    std::printf("  budget %.0f us: %llu overruns, mean tick uses %.1f%% of it\n", budgetUs,
+                static_cast<unsigned long long>(prof.overruns()), 100.0 * meanUs / budgetUs);
+
+    uint64_t rateLimited = 0, laneFull = 0, overflows = 0, underruns = 0;
+    for (const PlayerInputStats &p : server.inputStats()) {
+        rateLimited += p.drops.rateLimited;
+        laneFull += p.drops.laneFull;
+        overflows += p.queue.overflows;
+        underruns += p.queue.underruns;
+    }
+    std::printf("  inputs      processed %llu, dropped %llu (rate limited %llu, lane full %llu), jitter buffer "
+                "overflows %llu underruns %llu\n",
+                static_cast<unsigned long long>(prof.inputsProcessed()),
+                static_cast<unsigned long long>(prof.inputsDropped()), static_cast<unsigned long long>(rateLimited),
+                static_cast<unsigned long long>(laneFull), static_cast<unsigned long long>(overflows),
+                static_cast<unsigned long long>(underruns));
+    const double bytesPerTick =
+        prof.ticks() ? static_cast<double>(prof.snapshotBytes()) / static_cast<double>(prof.ticks()) : 0.0;
+    const double perClient = o.clients ? bytesPerTick / o.clients : 0.0;
+    std::printf("  snapshots   %.0f B/tick, %.0f B per client per tick (%.1f kbit/s)\n", bytesPerTick, perClient,
+                perClient * tickHz * 8e-3);
+}
+
+GameConfig roomConfig(const Options &o, uint32_t room) {
+    GameConfig config{o.clients + o.bots, 40.0f, o.bots, {}};
+    config.inputBufferDepth = o.depth;
+    config.mapPath = o.map;
+    if (o.seed != 0) config.seed = o.seed + room;
+    if (!o.record.empty()) config.recordPath = o.rooms > 1 ? o.record + "." + std::to_string(room) : o.record;
+    return config;
+}
+
+// One room stepped back to back on this thread.
+void runUnthrottled(const Options &o) {
+    auto server = std::make_unique<GameServer>();
+    GameConfig config = roomConfig(o, 0);
+    config.inputRate.rate = 0.0f; // the clients run faster than real time
+    server->startHeadless(config);
+    std::vector<SyntheticClient> clients = makeClients(o, 0);
+    const float dt = 1.0f / 60.0f;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t tick = 0; tick < o.ticks; ++tick) {
+        pushInputs(*server, clients, tick, dt, o);
+        server->step(dt);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("unthrottled: %u clients + %u bots, %u ticks in %.2f s (%.0f ticks/s)\n", o.clients, o.bots, o.ticks,
+                seconds, o.ticks / seconds);
+    report(*server, o, 60.0, false);
+}
+
+// Rooms on a worker pool at a fixed rate; this thread plays every client.
+void runFixed(const Options &o) {
+    RoomPool pool(o.workers);
+    std::vector<std::shared_ptr<GameServer>> rooms;
+    std::vector<std::vector<SyntheticClient>> clients;
+    for (uint32_t r = 0; r < o.rooms; ++r) {
+        rooms.push_back(pool.find(pool.create(roomConfig(o, r), o.rate)));
+        clients.push_back(makeClients(o, r));
+    }
+    const float dt = static_cast<float>(1.0 / o.rate);
+    const auto period = std::chrono::duration_cast<TickClock::duration>(std::chrono::duration<double>(1.0 / o.rate));
+    auto next = TickClock::now();
+    for (uint32_t tick = 0; tick < o.ticks; ++tick) {
+        for (uint32_t r = 0; r < o.rooms; ++r) pushInputs(*rooms[r], clients[r], tick, dt, o);
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+    const RoomPool::Stats stats = pool.stats();
+    std::printf("fixed %.0f Hz: %u room(s) of %u clients + %u bots on %u worker(s), %u ticks\n", o.rate, o.rooms,
+                o.clients, o.bots, pool.workerCount(), o.ticks);
+    std::printf("  pool        %llu ticks, %llu late, max start lag %.1f us\n",
+                static_cast<unsigned long long>(stats.ticks), static_cast<unsigned long long>(stats.lateTicks),
+                us(stats.maxLateNs));
+    for (uint32_t r = 0; r < o.rooms; ++r) {
+        if (o.rooms > 1) std::printf(" room %u\n", r);
+        report(*rooms[r], o, o.rate, true);
+    }
+    for (auto &room : rooms) room.reset();
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    Options o;
+    if (!parseOptions(argc, argv, o)) return 2;
+    std::string error;
+    if (!o.map.empty() && !MapFile::open(o.map, &error)) {
+        std::fprintf(stderr, "cannot load map: %s\n", error.c_str());
+        return 2;
+    }
+    if (o.rate <= 0.0) {
+        runUnthrottled(o);
+    } else {
+        runFixed(o);
+    }
+    return 0;
+}
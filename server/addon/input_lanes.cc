@@ -0,0 +1,116 @@
+#include "input_lanes.h"
+
+#include <algorithm>
+#include <chrono>
+
+#ifdef __linux__
+#include <time.h>
+#endif
+
+namespace {
+// Bucket refills only need millisecond resolution; the coarse clock skips
+// the full clock read on every push.
+uint64_t admissionNowNs() {
+#ifdef __linux__
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+#endif
+}
+} // namespace
+
+bool InputAdmission::admit(uint32_t playerId, uint64_t nowNs) {
+    if (limit_.rate <= 0.0f) return true;
+    auto [it, inserted] = buckets_.try_emplace(playerId, Bucket{limit_.burst, nowNs});
+    Bucket &bucket = it->second;
+    if (!inserted) {
+        const float elapsed = static_cast<float>(nowNs - bucket.lastNs) * 1e-9f;
+        bucket.tokens = std::min(limit_.burst, bucket.tokens + elapsed * limit_.rate);
+        bucket.lastNs = nowNs;
+    }
+    if (bucket.tokens < 1.0f) return false;
+    bucket.tokens -= 1.0f;
+    return true;
+}
+
+void InputAdmission::countDrop(uint32_t playerId, bool rateLimited) {
+    std::lock_guard<std::mutex> lock(dropsMutex_);
+    InputDrops &drops = drops_[playerId];
+    ++(rateLimited ? drops.rateLimited : drops.laneFull);
+}
+
+void InputAdmission::forget(uint32_t playerId) {
+    buckets_.erase(playerId);
+    std::lock_guard<std::mutex> lock(dropsMutex_);
+    drops_.erase(playerId);
+}
+
+void InputAdmission::clear() {
+    buckets_.clear();
+    std::lock_guard<std::mutex> lock(dropsMutex_);
+    drops_.clear();
+}
+
+void InputAdmission::collectDrops(std::unordered_map<uint32_t, InputDrops> &out) const {
+    std::lock_guard<std::mutex> lock(dropsMutex_);
+    for (const auto &[id, drops] : drops_) {
+        InputDrops &total = out[id];
+        total.rateLimited += drops.rateLimited;
+        total.laneFull += drops.laneFull;
+    }
+}
+
+InputLanes::InputLanes() : lanes_(new Lane[kLanes]) {
+    lanes_[kOwnerLane].claimed.store(true, std::memory_order_relaxed);
+}
+
+void InputLanes::configure(const InputRateLimit &limit) {
+    for (uint32_t i = 0; i < kLanes; ++i) {
+        lanes_[i].admission.configure(limit);
+        lanes_[i].admission.clear();
+    }
+}
+
+uint32_t InputLanes::claim() {
+    for (uint32_t i = 0; i < kLanes; ++i) {
+        if (i == kOwnerLane) continue;
+        bool expected = false;
+        if (lanes_[i].claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) return i;
+    }
+    return kNoLane;
+}
+
+void InputLanes::release(uint32_t lane) {
+    if (lane >= kLanes || lane == kOwnerLane) return;
+    lanes_[lane].admission.clear();
+    lanes_[lane].claimed.store(false, std::memory_order_release);
+}
+
+bool InputLanes::push(uint32_t lane, const InputPacket &packet) {
+    if (lane >= kLanes) return false;
+    Lane &l = lanes_[lane];
+    if (l.admission.limited() && !l.admission.admit(packet.playerId, admissionNowNs())) {
+        l.admission.countDrop(packet.playerId, true);
+        return false;
+    }
+    const uint32_t head = l.head.load(std::memory_order_relaxed);
+    if (head - l.tail.load(std::memory_order_acquire) >= kLaneCapacity) {
+        l.admission.countDrop(packet.playerId, false);
+        return false;
+    }
+    l.items[head % kLaneCapacity] = packet;
+    l.head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+void InputLanes::forget(uint32_t lane, uint32_t playerId) {
+    if (lane < kLanes) lanes_[lane].admission.forget(playerId);
+}
+
+void InputLanes::collectDrops(std::unordered_map<uint32_t, InputDrops> &out) const {
+    for (uint32_t i = 0; i < kLanes; ++i) lanes_[i].admission.collectDrops(out);
+}
@@ -0,0 +1,111 @@
+#ifndef INPUT_LANES_H
+#define INPUT_LANES_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "input_queue.h"
+
+// Per-player token bucket: rate commands per second, bursts of up to burst.
+// rate 0 admits everything.
+struct InputRateLimit {
+    float rate = 120.0f;
+    float burst = 60.0f;
+};
+
+struct InputDrops {
+    uint32_t rateLimited = 0; // over the player's token bucket
+    uint32_t laneFull = 0;    // the producer's lane had no room
+};
+
+// Admission state of one producer. admit() and forget() belong to that
+// producer's thread; drops are also readable from any thread.
+class InputAdmission {
+public:
+    void configure(const InputRateLimit &limit) { limit_ = limit; }
+    bool limited() const { return limit_.rate > 0.0f; }
+    bool admit(uint32_t playerId, uint64_t nowNs);
+    void countDrop(uint32_t playerId, bool rateLimited);
+    void forget(uint32_t playerId);
+    void clear();
+    // Adds this producer's drop counters into out.
+    void collectDrops(std::unordered_map<uint32_t, InputDrops> &out) const;
+
+private:
+    struct Bucket {
+        float tokens;
+        uint64_t lastNs;
+    };
+
+    InputRateLimit limit_;
+    std::unordered_map<uint32_t, Bucket> buckets_;
+    mutable std::mutex dropsMutex_; // only taken when dropping or reading
+    std::unordered_map<uint32_t, InputDrops> drops_;
+};
+
+// Input ingestion for one room: a fixed set of single-producer lanes, each
+// with its own capacity and token buckets, so a flooding producer or player
+// only loses its own commands. The tick thread drains every lane.
+class InputLanes {
+public:
+    static constexpr uint32_t kLanes = 8;
+    static constexpr uint32_t kLaneCapacity = 512;
+    static constexpr uint32_t kOwnerLane = 0; // the thread that owns the room
+    static constexpr uint32_t kNoLane = kLanes;
+
+    InputLanes();
+    InputLanes(const InputLanes &) = delete;
+    InputLanes &operator=(const InputLanes &) = delete;
+
+    // Call while no producer is pushing.
+    void configure(const InputRateLimit &limit);
+
+    // Reserves a lane for the calling thread; kNoLane if all are taken.
+    uint32_t claim();
+    // By the lane's producer, once it stops pushing.
+    void release(uint32_t lane);
+
+    // Producer of lane only. False if the command was refused.
+    bool push(uint32_t lane, const InputPacket &packet);
+    // Producer of lane only: drops the player's bucket and counters.
+    void forget(uint32_t lane, uint32_t playerId);
+
+    // Tick thread: hands every queued command to fn, starting from a
+    // different lane each call. Returns the number of commands.
+    template <typename Fn>
+    uint32_t drain(Fn &&fn);
+
+    void collectDrops(std::unordered_map<uint32_t, InputDrops> &out) const;
+
+private:
+    struct alignas(64) Lane {
+        alignas(64) std::atomic<uint32_t> head{0};
+        alignas(64) std::atomic<uint32_t> tail{0};
+        alignas(64) std::atomic<bool> claimed{false};
+        InputAdmission admission;
+        std::array<InputPacket, kLaneCapacity> items;
+    };
+
+    std::unique_ptr<Lane[]> lanes_;
+    uint32_t nextDrain_ = 0;
+};
+
+template <typename Fn>
+uint32_t InputLanes::drain(Fn &&fn) {
+    uint32_t count = 0;
+    for (uint32_t n = 0; n < kLanes; ++n) {
+        Lane &lane = lanes_[(nextDrain_ + n) % kLanes];
+        const uint32_t head = lane.head.load(std::memory_order_acquire);
+        uint32_t tail = lane.tail.load(std::memory_order_relaxed);
+        for (; tail != head; ++tail, ++count) fn(lane.items[tail % kLaneCapacity]);
+        lane.tail.store(tail, std::memory_order_release);
+    }
+    nextDrain_ = (nextDrain_ + 1) % kLanes;
+    return count;
+}
+
+#endif
@@ -0,0 +1,154 @@
+#include "input_log.h"
+
+#include <cstring>
+
+namespace {
+constexpr uint32_t kMagic = 0x4C494642; // "BFIL"
+// Bumped whenever the simulation changes what a log replays to (version 3:
+// fast trig; 4: movement back on libm). Older logs are refused rather than
+// reported as diverging.
+constexpr uint32_t kVersion = 4;
+constexpr uint32_t kMaxMapPath = 4096;
+constexpr size_t kRecordSize = 4 + kInputWireSize;
+constexpr size_t kFileBuffer = 1 << 20;
+
+template <typename T>
+void put(std::vector<uint8_t> &out, const T &v) {
+    const size_t at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(out.data() + at, &v, sizeof(T));
+}
+
+template <typename T>
+bool get(std::FILE *file, T &v) {
+    return std::fread(&v, sizeof(T), 1, file) == 1;
+}
+
+uint64_t mix(uint64_t h, uint64_t v) {
+    h ^= v * 0xBF58476D1CE4E5B9ull;
+    h = (h << 27 | h >> 37) * 0x94D049BB133111EBull;
+    return h;
+}
+} // namespace
+
+bool InputLogWriter::open(const std::string &path, const InputLogHeader &header) {
+    close();
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) return false;
+    std::setvbuf(file_, nullptr, _IOFBF, kFileBuffer);
+    std::vector<uint8_t> out;
+    put(out, kMagic);
+    put(out, kVersion);
+    put(out, header.seed);
+    put(out, header.maxPlayers);
+    put(out, header.worldHalfExtent);
+    put(out, header.botCount);
+    put(out, header.inputBufferDepth);
+    put(out, header.maxRewindTicks);
+    put(out, header.snapshotPrecision.positionBits);
+    put(out, header.snapshotPrecision.velocityBits);
+    put(out, header.snapshotPrecision.yawBits);
+    put(out, header.snapshotPrecision.pitchBits);
+    put(out, static_cast<uint32_t>(header.mapPath.size()));
+    out.insert(out.end(), header.mapPath.begin(), header.mapPath.end());
+    std::fwrite(out.data(), 1, out.size(), file_);
+    tick_.clear();
+    count_ = 0;
+    return true;
+}
+
+void InputLogWriter::close() {
+    if (!file_) return;
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+void InputLogWriter::input(const InputPacket &packet) {
+    if (!file_) return;
+    const size_t at = tick_.size();
+    tick_.resize(at + kRecordSize);
+    std::memcpy(tick_.data() + at, &packet.playerId, 4);
+    encodeInputPacket(packet, tick_.data() + at + 4);
+    ++count_;
+}
+
+void InputLogWriter::endTick(uint32_t tick, float dt, uint64_t stateHash) {
+    if (!file_) return;
+    uint8_t head[12];
+    std::memcpy(head, &tick, 4);
+    std::memcpy(head + 4, &dt, 4);
+    std::memcpy(head + 8, &count_, 4);
+    std::fwrite(head, 1, sizeof(head), file_);
+    std::fwrite(tick_.data(), 1, tick_.size(), file_);
+    std::fwrite(&stateHash, sizeof(stateHash), 1, file_);
+    tick_.clear();
+    count_ = 0;
+}
+
+InputLogReader::~InputLogReader() {
+    if (file_) std::fclose(file_);
+}
+
+bool InputLogReader::open(const std::string &path) {
+    if (file_) std::fclose(file_);
+    file_ = std::fopen(path.c_str(), "rb");
+    if (!file_) return false;
+    std::setvbuf(file_, nullptr, _IOFBF, kFileBuffer);
+    size_ = 0;
+    if (std::fseek(file_, 0, SEEK_END) == 0) {
+        const long end = std::ftell(file_);
+        size_ = end > 0 ? static_cast<uint64_t>(end) : 0;
+    }
+    std::rewind(file_);
+    uint32_t magic = 0, version = 0;
+    InputLogHeader &h = header_;
+    SnapshotPrecision &p = h.snapshotPrecision;
+    bool ok = get(file_, magic) && get(file_, version) && magic == kMagic && version == kVersion &&
+              get(file_, h.seed) && get(file_, h.maxPlayers) && get(file_, h.worldHalfExtent) &&
+              get(file_, h.botCount) && get(file_, h.inputBufferDepth) && get(file_, h.maxRewindTicks) &&
+              get(file_, p.positionBits) && get(file_, p.velocityBits) && get(file_, p.yawBits) &&
+              get(file_, p.pitchBits);
+    h.mapPath.clear();
+    uint32_t mapPathSize = 0;
+    ok = ok && get(file_, mapPathSize) && mapPathSize <= kMaxMapPath;
+    h.mapPath.resize(ok ? mapPathSize : 0);
+    ok = ok && std::fread(&h.mapPath[0], 1, mapPathSize, file_) == mapPathSize;
+    if (!ok) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+    return ok;
+}
+
+bool InputLogReader::next(InputLogTick &out) {
+    if (!file_) return false;
+    uint32_t count = 0;
+    if (!get(file_, out.tick) || !get(file_, out.dt) || !get(file_, count)) return false;
+    // A corrupt count must not size the vector: the records have to be in the file.
+    const long at = std::ftell(file_);
+    if (at < 0 || static_cast<uint64_t>(at) > size_ ||
+        uint64_t{count} * kRecordSize + sizeof(out.stateHash) > size_ - static_cast<uint64_t>(at)) {
+        return false;
+    }
+    out.inputs.resize(count);
+    uint8_t record[kRecordSize];
+    for (InputPacket &packet : out.inputs) {
+        if (std::fread(record, 1, kRecordSize, file_) != kRecordSize) return false;
+        uint32_t playerId;
+        std::memcpy(&playerId, record, 4);
+        parseInputPacket(playerId, record + 4, kInputWireSize, packet);
+    }
+    return get(file_, out.stateHash);
+}
+
+void StateHasher::add(const void *data, size_t bytes) {
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    for (; bytes >= 8; bytes -= 8, p += 8) {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        h_ = mix(h_, v);
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, p, bytes);
+    h_ = mix(h_, tail ^ (static_cast<uint64_t>(bytes) << 56));
+}
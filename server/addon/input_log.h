@@ -0,0 +1,94 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "input_queue.h"
+#include "snapshot_codec.h"
+
+// Room settings a replay needs to rebuild the same world.
+struct InputLogHeader {
+    uint32_t seed = 0;
+    uint32_t maxPlayers = 0;
+    float worldHalfExtent = 0.0f;
+    uint32_t botCount = 0;
+    uint32_t inputBufferDepth = 1;
+    uint32_t maxRewindTicks = 0;
+    SnapshotPrecision snapshotPrecision;
+    std::string mapPath; // empty for the built-in map
+};
+
+// One simulated tick: the commands queued during it, in order, and the
+// state hash after it.
+struct InputLogTick {
+    uint32_t tick = 0;
+    float dt = 0.0f;
+    std::vector<InputPacket> inputs;
+    uint64_t stateHash = 0;
+};
+
+// Binary input log (host byte order):
+//   header: "BFIL" | u32 version | u32 seed | u32 maxPlayers | f32 worldHalfExtent |
+//           u32 botCount | u32 inputBufferDepth | u32 maxRewindTicks | u8 x4 snapshot bits |
+//           u32 mapPath length | mapPath bytes
+// Only the current version is read: logs from a build that simulated
+// differently cannot replay.
+//   per tick: u32 tick | f32 dt | u32 count | count x (u32 playerId | 27-byte wire packet) |
+//             u64 stateHash
+// Written on the tick thread through a large stdio buffer.
+class InputLogWriter {
+public:
+    InputLogWriter() = default;
+    InputLogWriter(const InputLogWriter &) = delete;
+    InputLogWriter &operator=(const InputLogWriter &) = delete;
+    ~InputLogWriter() { close(); }
+
+    bool open(const std::string &path, const InputLogHeader &header);
+    void close();
+    bool isOpen() const { return file_ != nullptr; }
+
+    void input(const InputPacket &packet);
+    void endTick(uint32_t tick, float dt, uint64_t stateHash);
+
+private:
+    std::FILE *file_ = nullptr;
+    std::vector<uint8_t> tick_; // inputs of the current tick
+    uint32_t count_ = 0;
+};
+
+class InputLogReader {
+public:
+    InputLogReader() = default;
+    InputLogReader(const InputLogReader &) = delete;
+    InputLogReader &operator=(const InputLogReader &) = delete;
+    ~InputLogReader();
+
+    bool open(const std::string &path);
+    const InputLogHeader &header() const { return header_; }
+    // False at the end of the log or on a truncated or corrupt record.
+    bool next(InputLogTick &out);
+
+private:
+    std::FILE *file_ = nullptr;
+    uint64_t size_ = 0; // of the file, to bound record counts
+    InputLogHeader header_;
+};
+
+// 64-bit hash of simulation state, fed array by array.
+class StateHasher {
+public:
+    void add(const void *data, size_t bytes);
+    template <typename T>
+    void add(const std::vector<T> &v) {
+        add(v.data(), v.size() * sizeof(T));
+    }
+    uint64_t value() const { return h_; }
+
+private:
+    uint64_t h_ = 0x9E3779B97F4A7C15ull;
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "input_queue.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+bool parseInputPacket(uint32_t playerId, const uint8_t *data, size_t len, InputPacket &out) {
+    if (len < kInputWireMinSize) return false;
+    size_t idx = 0;
+    auto read32 = [&]() {
+        uint32_t v;
+        std::memcpy(&v, data + idx, sizeof(v));
+        idx += sizeof(v);
+        return v;
+    };
+    auto readFloat = [&]() {
+        float v;
+        std::memcpy(&v, data + idx, sizeof(v));
+        idx += sizeof(v);
+        return v;
+    };
+
+    out = InputPacket{};
+    out.playerId = playerId;
+    out.seq = read32();
+    out.moveX = readFloat();
+    out.moveZ = readFloat();
+    out.yaw = readFloat();
+    out.pitch = readFloat();
+    out.fire = data[idx] != 0;
+    idx += 1;
+    out.weapon = data[idx];
+    idx += 1;
+    out.jump = idx < len ? (data[idx] != 0) : false;
+    idx += 1;
+    out.ackTick = idx + sizeof(uint32_t) <= len ? read32() : 0;
+    // NaN or infinity would reach float-to-int conversions (grid cells,
+    // snapshot quantization) that are undefined for them.
+    return std::isfinite(out.moveX) && std::isfinite(out.moveZ) && std::isfinite(out.yaw) && std::isfinite(out.pitch);
+}
+
+void encodeInputPacket(const InputPacket &packet, uint8_t *out) {
+    size_t idx = 0;
+    auto write = [&](const void *v, size_t n) {
+        std::memcpy(out + idx, v, n);
+        idx += n;
+    };
+    write(&packet.seq, 4);
+    write(&packet.moveX, 4);
+    write(&packet.moveZ, 4);
+    write(&packet.yaw, 4);
+    write(&packet.pitch, 4);
+    out[idx++] = packet.fire ? 1 : 0;
+    out[idx++] = packet.weapon;
+    out[idx++] = packet.jump ? 1 : 0;
+    write(&packet.ackTick, 4);
+}
+
+void InputQueue::reset(uint32_t depth) {
+    head_ = 0;
+    count_ = 0;
+    depth_ = std::max(1u, std::min(depth, kCapacity));
+    // Room for a burst twice the target depth before the oldest commands go.
+    limit_ = std::min(kCapacity, depth_ * 2 + 2);
+    primed_ = false;
+    released_ = false;
+    lastSeq_ = 0;
+    stats_ = InputQueueStats{};
+}
+
+void InputQueue::push(const InputPacket &packet) {
+    if (released_ && !before(lastSeq_, packet.seq)) {
+        ++stats_.late;
+        return;
+    }
+    // Insertion point from the back; arrivals are almost always in order.
+    uint32_t pos = count_;
+    while (pos > 0 && before(packet.seq, at(pos - 1).seq)) --pos;
+    if (pos > 0 && at(pos - 1).seq == packet.seq) {
+        ++stats_.duplicates;
+        return;
+    }
+    if (count_ == limit_) {
+        if (pos == 0) {
+            ++stats_.overflows; // older than everything buffered in a full queue
+            return;
+        }
+        lastSeq_ = at(0).seq;
+        released_ = true;
+        head_ = (head_ + 1) % kCapacity;
+        --count_;
+        --pos;
+        ++stats_.overflows;
+    }
+    for (uint32_t i = count_; i > pos; --i) at(i) = at(i - 1);
+    at(pos) = packet;
+    ++count_;
+    if (count_ >= depth_) primed_ = true;
+}
+
+bool InputQueue::pop(InputPacket &packet) {
+    if (!primed_) return false;
+    if (count_ == 0) {
+        ++stats_.underruns;
+        primed_ = false;
+        return false;
+    }
+    packet = at(0);
+    head_ = (head_ + 1) % kCapacity;
+    --count_;
+    lastSeq_ = packet.seq;
+    released_ = true;
+    return true;
+}
+
+InputQueueStats InputQueue::stats() const {
+    InputQueueStats s = stats_;
+    s.buffered = count_;
+    return s;
+}
@@ -0,0 +1,70 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+struct InputPacket {
+    uint32_t playerId;
+    uint32_t seq;
+    float moveX;
+    float moveZ;
+    float yaw;
+    float pitch;
+    bool fire;
+    uint8_t weapon;
+    bool jump;
+    uint32_t ackTick; // latest snapshot tick the client has decoded, 0 if none
+};
+
+// Client wire format: u32 seq | f32 moveX | f32 moveZ | f32 yaw | f32 pitch |
+// u8 fire | u8 weapon | u8 jump | u32 ackTick. The trailing jump and ackTick
+// are optional for older clients.
+constexpr size_t kInputWireMinSize = 23;
+constexpr size_t kInputWireSize = 27;
+
+// Parses one wire packet; false if it is too short or a move or angle is not finite.
+bool parseInputPacket(uint32_t playerId, const uint8_t *data, size_t len, InputPacket &out);
+// Writes the full kInputWireSize form of packet (without its player id).
+void encodeInputPacket(const InputPacket &packet, uint8_t *out);
+
+struct InputQueueStats {
+    uint32_t buffered = 0;   // commands waiting right now
+    uint32_t underruns = 0;  // ticks the buffer ran dry after filling
+    uint32_t overflows = 0;  // oldest commands dropped to stay bounded
+    uint32_t duplicates = 0; // seq already buffered
+    uint32_t late = 0;       // seq at or before the last released command
+};
+
+// Per-player jitter buffer. Commands are kept in seq order and released one
+// per tick, starting once depth of them have built up (and again after the
+// buffer runs dry). Repeated and stale seqs are dropped, so a client may
+// resend recent commands for redundancy.
+class InputQueue {
+public:
+    static constexpr uint32_t kCapacity = 16;
+
+    void reset(uint32_t depth);
+    void push(const InputPacket &packet);
+    bool pop(InputPacket &packet);
+    uint32_t size() const { return count_; }
+    InputQueueStats stats() const;
+
+private:
+    // Serial-number order, so seq may wrap.
+    static bool before(uint32_t a, uint32_t b) { return static_cast<int32_t>(a - b) < 0; }
+    InputPacket &at(uint32_t i) { return items_[(head_ + i) % kCapacity]; }
+
+    std::array<InputPacket, kCapacity> items_{};
+    uint32_t head_ = 0;
+    uint32_t count_ = 0;
+    uint32_t depth_ = 1;
+    uint32_t limit_ = kCapacity;
+    bool primed_ = false;
+    bool released_ = false; // lastSeq_ is valid
+    uint32_t lastSeq_ = 0;
+    InputQueueStats stats_;
+};
+
+#endif
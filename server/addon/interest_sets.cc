@@ -0,0 +1,59 @@
+#include "interest_sets.h"
+
+#include <algorithm>
+
+void InterestSets::reset(float radius, float margin) {
+    radius_ = std::max(0.0f, radius);
+    margin_ = std::max(0.0f, margin);
+    clear();
+}
+
+void InterestSets::clear() {
+    viewers_.clear();
+}
+
+const std::vector<uint32_t> &InterestSets::update(uint32_t viewerId, uint32_t tick,
+                                                  const std::vector<std::pair<uint32_t, float>> &nearby) {
+    Viewer &viewer = viewers_[viewerId];
+    const Entry &last = viewer.entries[viewer.latest % kTicks];
+    const std::vector<uint32_t> *previous = last.valid && last.tick == viewer.latest ? &last.ids : nullptr;
+
+    // Built aside: tick may share a ring entry with the previous set.
+    std::vector<uint32_t> &ids = scratch_;
+    ids.clear();
+    const float enter2 = radius_ * radius_;
+    for (const auto &candidate : nearby) {
+        const bool stays = previous && std::binary_search(previous->begin(), previous->end(), candidate.first);
+        if (candidate.second <= enter2 || stays) ids.push_back(candidate.first);
+    }
+    std::sort(ids.begin(), ids.end());
+
+    Entry &entry = viewer.entries[tick % kTicks];
+    entry.tick = tick;
+    entry.valid = true;
+    entry.ids.swap(ids);
+    viewer.latest = tick;
+    return entry.ids;
+}
+
+const std::vector<uint32_t> *InterestSets::find(uint32_t viewerId, uint32_t tick) const {
+    const auto it = viewers_.find(viewerId);
+    if (it == viewers_.end()) return nullptr;
+    const Entry &entry = it->second.entries[tick % kTicks];
+    return entry.valid && entry.tick == tick ? &entry.ids : nullptr;
+}
+
+void InterestSets::forget(uint32_t viewerId) {
+    viewers_.erase(viewerId);
+}
+
+void InterestSets::select(const std::vector<EntitySnapshot> &all, const std::vector<uint32_t> &ids,
+                          std::vector<EntitySnapshot> &out) {
+    out.clear();
+    size_t a = 0;
+    for (const uint32_t id : ids) {
+        while (a < all.size() && all[a].id < id) ++a;
+        if (a == all.size()) break;
+        if (all[a].id == id) out.push_back(all[a]);
+    }
+}
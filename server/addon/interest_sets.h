@@ -0,0 +1,56 @@
+#ifndef INTEREST_SETS_H
+#define INTEREST_SETS_H
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "snapshot_codec.h"
+
+// Which entities each client is sent. An entity enters a viewer's set
+// within radius and leaves it only beyond radius + margin, so players near
+// the edge don't flicker in and out. The sets of the last
+// SnapshotHistory::kTicks ticks are kept per viewer, so a delta against an
+// acked tick is built from exactly what that client was sent then.
+class InterestSets {
+public:
+    static constexpr uint32_t kTicks = SnapshotHistory::kTicks;
+
+    // radius 0 disables filtering.
+    void reset(float radius, float margin);
+    void clear();
+    bool enabled() const { return radius_ > 0.0f; }
+    float exitRadius() const { return radius_ + margin_; }
+
+    // Builds viewerId's set for tick from (id, squared distance) of the
+    // entities within exitRadius() of it; returns the ids, sorted.
+    const std::vector<uint32_t> &update(uint32_t viewerId, uint32_t tick,
+                                        const std::vector<std::pair<uint32_t, float>> &nearby);
+    // viewerId's set as of tick, or null if none was built then.
+    const std::vector<uint32_t> *find(uint32_t viewerId, uint32_t tick) const;
+    void forget(uint32_t viewerId);
+
+    // The entities of all (sorted by id) whose ids are in ids (sorted).
+    static void select(const std::vector<EntitySnapshot> &all, const std::vector<uint32_t> &ids,
+                       std::vector<EntitySnapshot> &out);
+
+private:
+    struct Entry {
+        uint32_t tick = 0;
+        bool valid = false;
+        std::vector<uint32_t> ids;
+    };
+    struct Viewer {
+        std::array<Entry, kTicks> entries;
+        uint32_t latest = 0; // tick of the newest entry
+    };
+
+    float radius_ = 0.0f;
+    float margin_ = 0.0f;
+    std::unordered_map<uint32_t, Viewer> viewers_;
+    std::vector<uint32_t> scratch_; // swapped with the entry written, so buffers are reused
+};
+
+#endif
@@ -0,0 +1,232 @@
+#include "map_file.h"
+#include "collider_grid.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr uint32_t kMagic = 0x504D4642; // "BFMP"; a big-endian host fails here
+constexpr uint32_t kVersion = 1;
+constexpr int kMaxCellsPerSide = 4096;
+static_assert(sizeof(Wall) == 16 && sizeof(Platform) == 20 && sizeof(SpawnPoint) == 8, "map records are packed f32s");
+
+template <typename T>
+void put(std::vector<uint8_t> &out, const T &v) {
+    const size_t at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(out.data() + at, &v, sizeof(T));
+}
+
+template <typename T>
+void putArray(std::vector<uint8_t> &out, const T *v, size_t count) {
+    const size_t at = out.size();
+    out.resize(at + count * sizeof(T));
+    if (count) std::memcpy(out.data() + at, v, count * sizeof(T));
+}
+
+// Cell offsets then items of one grid; all-empty cells if there is nothing in it.
+void putGrid(std::vector<uint8_t> &out, const ColliderGrid &grid, size_t cells) {
+    if (grid.empty()) {
+        const std::vector<uint32_t> none(cells + 1, 0);
+        putArray(out, none.data(), none.size());
+        return;
+    }
+    putArray(out, grid.cellStart(), cells + 1);
+    putArray(out, grid.items(), grid.itemCount());
+}
+
+// Offsets and items of a baked grid are consistent and in range.
+bool validGrid(const uint32_t *cellStart, size_t cells, uint32_t items, uint32_t colliders) {
+    if (cellStart[0] != 0 || cellStart[cells] != items) return false;
+    for (size_t c = 0; c < cells; ++c) {
+        if (cellStart[c] > cellStart[c + 1]) return false;
+    }
+    const uint32_t *item = cellStart + cells + 1;
+    for (uint32_t k = 0; k < items; ++k) {
+        if (item[k] >= colliders) return false;
+    }
+    return true;
+}
+
+// Identifies one version of a file, so a re-exported map is mapped afresh.
+struct FileKey {
+    uint64_t device = 0, inode = 0, size = 0;
+    int64_t modified = 0;
+};
+
+std::mutex gMapsMutex;
+std::unordered_map<std::string, std::pair<FileKey, std::weak_ptr<const MapFile>>> gMaps;
+} // namespace
+
+MapFile::~MapFile() {
+#ifndef _WIN32
+    if (data_ && copy_.empty()) munmap(const_cast<void *>(data_), size_);
+#endif
+}
+
+std::shared_ptr<const MapFile> MapFile::open(const std::string &path, std::string *error) {
+    std::string ignored;
+    std::string &err = error ? *error : ignored;
+    FileKey key;
+    std::shared_ptr<MapFile> map(new MapFile());
+#ifndef _WIN32
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        err = "cannot open " + path;
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        err = "cannot read " + path;
+        return nullptr;
+    }
+    key.device = static_cast<uint64_t>(st.st_dev);
+    key.inode = static_cast<uint64_t>(st.st_ino);
+    key.size = static_cast<uint64_t>(st.st_size);
+    key.modified = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    {
+        std::lock_guard<std::mutex> lock(gMapsMutex);
+        const auto it = gMaps.find(path);
+        if (it != gMaps.end()) {
+            const FileKey &k = it->second.first;
+            std::shared_ptr<const MapFile> shared = it->second.second.lock();
+            if (shared && k.device == key.device && k.inode == key.inode && k.size == key.size &&
+                k.modified == key.modified) {
+                ::close(fd);
+                return shared;
+            }
+        }
+    }
+    void *data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        err = "cannot map " + path;
+        return nullptr;
+    }
+    map->data_ = data;
+    map->size_ = static_cast<size_t>(st.st_size);
+#else
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        err = "cannot open " + path;
+        return nullptr;
+    }
+    uint8_t chunk[1 << 16];
+    size_t got;
+    while ((got = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        map->copy_.insert(map->copy_.end(), chunk, chunk + got);
+    }
+    std::fclose(file);
+    if (map->copy_.empty()) {
+        err = "cannot read " + path;
+        return nullptr;
+    }
+    map->data_ = map->copy_.data();
+    map->size_ = map->copy_.size();
+#endif
+    if (!map->index(err)) {
+        err = path + ": " + err;
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(gMapsMutex);
+    gMaps[path] = {key, map};
+    return map;
+}
+
+bool MapFile::index(std::string &error) {
+    if (size_ < sizeof(Header)) {
+        error = "truncated header";
+        return false;
+    }
+    const Header &h = *header();
+    if (h.magic != kMagic || h.version != kVersion) {
+        error = "not a version 1 map file";
+        return false;
+    }
+    if (h.fileSize != size_) {
+        error = "size does not match the header";
+        return false;
+    }
+    if (!(std::isfinite(h.worldHalfExtent) && h.worldHalfExtent > 0.0f && std::isfinite(h.cellSize) &&
+          h.cellSize > 0.0f) ||
+        2.0f * h.worldHalfExtent / h.cellSize > static_cast<float>(kMaxCellsPerSide)) {
+        error = "bad world extent or cell size";
+        return false;
+    }
+    const int dim = ColliderGrid::cellsPerSide(h.worldHalfExtent, h.cellSize);
+    cells_ = static_cast<size_t>(dim) * static_cast<size_t>(dim);
+    const uint64_t expected = sizeof(Header) + uint64_t{h.walls} * sizeof(Wall) +
+                              uint64_t{h.platforms} * sizeof(Platform) + uint64_t{h.spawns} * sizeof(SpawnPoint) +
+                              2 * (cells_ + 1) * sizeof(uint32_t) +
+                              (uint64_t{h.wallItems} + h.platformItems) * sizeof(uint32_t);
+    if (expected != size_) {
+        error = "section sizes do not add up";
+        return false;
+    }
+    const uint8_t *p = static_cast<const uint8_t *>(data_) + sizeof(Header);
+    walls_ = reinterpret_cast<const Wall *>(p);
+    p += size_t{h.walls} * sizeof(Wall);
+    platforms_ = reinterpret_cast<const Platform *>(p);
+    p += size_t{h.platforms} * sizeof(Platform);
+    spawns_ = reinterpret_cast<const SpawnPoint *>(p);
+    p += size_t{h.spawns} * sizeof(SpawnPoint);
+    wallCells_ = reinterpret_cast<const uint32_t *>(p);
+    p += (cells_ + 1 + h.wallItems) * sizeof(uint32_t);
+    platformCells_ = reinterpret_cast<const uint32_t *>(p);
+    if (!validGrid(wallCells_, cells_, h.wallItems, h.walls) ||
+        !validGrid(platformCells_, cells_, h.platformItems, h.platforms)) {
+        error = "corrupt collider grid";
+        return false;
+    }
+    return true;
+}
+
+bool writeMapFile(const std::string &path, const MapGeometry &map) {
+    ColliderGrid wallGrid, platformGrid;
+    wallGrid.build(map.walls, map.worldHalfExtent, map.cellSize);
+    platformGrid.build(map.platforms, map.worldHalfExtent, map.cellSize);
+    const int dim = ColliderGrid::cellsPerSide(map.worldHalfExtent, map.cellSize);
+    const size_t cells = static_cast<size_t>(dim) * static_cast<size_t>(dim);
+
+    std::vector<uint8_t> out;
+    put(out, kMagic);
+    put(out, kVersion);
+    put(out, uint32_t{0}); // file size, filled in below
+    put(out, map.worldHalfExtent);
+    put(out, map.cellSize);
+    put(out, static_cast<uint32_t>(map.walls.size()));
+    put(out, static_cast<uint32_t>(map.platforms.size()));
+    put(out, static_cast<uint32_t>(map.spawns.size()));
+    put(out, static_cast<uint32_t>(wallGrid.itemCount()));
+    put(out, static_cast<uint32_t>(platformGrid.itemCount()));
+    putArray(out, map.walls.data(), map.walls.size());
+    putArray(out, map.platforms.data(), map.platforms.size());
+    putArray(out, map.spawns.data(), map.spawns.size());
+    putGrid(out, wallGrid, cells);
+    putGrid(out, platformGrid, cells);
+    const uint32_t size = static_cast<uint32_t>(out.size());
+    std::memcpy(out.data() + 8, &size, 4);
+
+    // Written beside the target and renamed over it, so rooms still using
+    // the old file keep a consistent mapping.
+    const std::string temp = path + ".tmp";
+    std::FILE *file = std::fopen(temp.c_str(), "wb");
+    if (!file) return false;
+    const bool ok = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    if (std::fclose(file) != 0 || !ok) {
+        std::remove(temp.c_str());
+        return false;
+    }
+    return std::rename(temp.c_str(), path.c_str()) == 0;
+}
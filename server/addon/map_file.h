@@ -0,0 +1,97 @@
+#ifndef MAP_FILE_H
+#define MAP_FILE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct Wall {
+    float minX;
+    float maxX;
+    float minZ;
+    float maxZ;
+};
+
+struct Platform {
+    float minX;
+    float maxX;
+    float minZ;
+    float maxZ;
+    float height;
+};
+
+struct SpawnPoint {
+    float x;
+    float z;
+};
+
+// Map geometry as the exporter (client/scripts/exportMap.ts) describes it.
+struct MapGeometry {
+    float worldHalfExtent = 50.0f;
+    float cellSize = 4.0f; // collider grid cells
+    std::vector<Wall> walls;
+    std::vector<Platform> platforms;
+    std::vector<SpawnPoint> spawns;
+};
+
+// Binary map (little-endian, every field 4 bytes, so the arrays are used in
+// place once mapped):
+//   header: "BFMP" | u32 version | u32 fileSize | f32 worldHalfExtent | f32 cellSize |
+//           u32 walls | u32 platforms | u32 spawns | u32 wallItems | u32 platformItems
+//   walls x (minX, maxX, minZ, maxZ) | platforms x (minX, maxX, minZ, maxZ, height) |
+//   spawns x (x, z) |
+//   wall grid: u32 cellStart[dim * dim + 1] | u32 items[wallItems] | platform grid: the same
+// where dim = ColliderGrid::cellsPerSide(worldHalfExtent, cellSize). The grids
+// are ColliderGrid's cell lists, baked by the exporter.
+class MapFile {
+public:
+    // Maps path read-only and checks its layout. Rooms opening the same,
+    // unchanged file share one mapping. Null on failure, with error set.
+    static std::shared_ptr<const MapFile> open(const std::string &path, std::string *error = nullptr);
+
+    MapFile(const MapFile &) = delete;
+    MapFile &operator=(const MapFile &) = delete;
+    ~MapFile();
+
+    float worldHalfExtent() const { return header()->worldHalfExtent; }
+    float cellSize() const { return header()->cellSize; }
+    uint32_t wallCount() const { return header()->walls; }
+    uint32_t platformCount() const { return header()->platforms; }
+    uint32_t spawnCount() const { return header()->spawns; }
+    const Wall *walls() const { return walls_; }
+    const Platform *platforms() const { return platforms_; }
+    const SpawnPoint *spawns() const { return spawns_; }
+    const uint32_t *wallCells() const { return wallCells_; }
+    const uint32_t *wallItems() const { return wallCells_ + cells_ + 1; }
+    const uint32_t *platformCells() const { return platformCells_; }
+    const uint32_t *platformItems() const { return platformCells_ + cells_ + 1; }
+
+private:
+    struct Header {
+        uint32_t magic, version, fileSize;
+        float worldHalfExtent, cellSize;
+        uint32_t walls, platforms, spawns, wallItems, platformItems;
+    };
+
+    MapFile() = default;
+    const Header *header() const { return static_cast<const Header *>(data_); }
+    // Points the arrays into data_ if the layout is sound.
+    bool index(std::string &error);
+
+    const void *data_ = nullptr;
+    size_t size_ = 0;
+    std::vector<uint8_t> copy_; // where mmap is unavailable
+    const Wall *walls_ = nullptr;
+    const Platform *platforms_ = nullptr;
+    const SpawnPoint *spawns_ = nullptr;
+    const uint32_t *wallCells_ = nullptr;
+    const uint32_t *platformCells_ = nullptr;
+    size_t cells_ = 0;
+};
+
+// Writes geometry in the format above, baking its collider grids. The
+// exporter is the usual source of map files; this is for tools and benches.
+bool writeMapFile(const std::string &path, const MapGeometry &map);
+
+#endif
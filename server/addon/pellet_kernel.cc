@@ -0,0 +1,112 @@
+#include "pellet_kernel.h"
+
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PELLET_KERNEL_SSE2 1
+#endif
+
+namespace {
+// Picks the best lane of a vector block result: smallest distance, then lowest slot.
+void reduceLanes(const float *dist, const float *slot, int lanes, PelletHit &hit) {
+    for (int l = 0; l < lanes; ++l) {
+        if (slot[l] < 0.0f) continue;
+        const int32_t s = static_cast<int32_t>(slot[l]);
+        if (hit.target == kPelletMiss || dist[l] < hit.dist || (dist[l] == hit.dist && s < hit.target)) {
+            hit.target = s;
+            hit.dist = dist[l];
+        }
+    }
+}
+
+// Slots [begin, end) one at a time; strict < keeps the lowest slot on ties.
+void scanScalar(float ox, float oy, float oz, float dx, float dy, float dz, const SphereTargets &targets, size_t begin,
+                size_t end, float radius, float maxDist, PelletHit &hit) {
+    for (size_t i = begin; i < end; ++i) {
+        float t = 0.0f;
+        if (!raySphereIntersect(ox, oy, oz, dx, dy, dz, targets.x[i], targets.y[i], targets.z[i], radius, maxDist, t)) {
+            continue;
+        }
+        if (hit.target == kPelletMiss || t < hit.dist) {
+            hit.target = static_cast<int32_t>(i);
+            hit.dist = t;
+        }
+    }
+}
+
+#if defined(PELLET_KERNEL_SSE2)
+inline __m128 select(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+void nearestSse2(float ox, float oy, float oz, const float *dx, const float *dy, const float *dz, int count,
+                 const SphereTargets &targets, float radius, float maxDist, PelletHit *out) {
+    const size_t n = targets.size();
+    const size_t blocks = n & ~static_cast<size_t>(3);
+    const __m128 vox = _mm_set1_ps(ox), voy = _mm_set1_ps(oy), voz = _mm_set1_ps(oz);
+    const __m128 r2 = _mm_set1_ps(radius * radius);
+    const __m128 vmax = _mm_set1_ps(maxDist);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 four = _mm_set1_ps(4.0f);
+    alignas(16) float dist[4];
+    alignas(16) float slot[4];
+    for (int p = 0; p < count; ++p) {
+        const __m128 vdx = _mm_set1_ps(dx[p]), vdy = _mm_set1_ps(dy[p]), vdz = _mm_set1_ps(dz[p]);
+        __m128 best = _mm_set1_ps(std::numeric_limits<float>::infinity());
+        __m128 bestSlot = _mm_set1_ps(-1.0f);
+        __m128 lane = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        for (size_t i = 0; i < blocks; i += 4) {
+            const __m128 lx = _mm_sub_ps(_mm_loadu_ps(&targets.x[i]), vox);
+            const __m128 ly = _mm_sub_ps(_mm_loadu_ps(&targets.y[i]), voy);
+            const __m128 lz = _mm_sub_ps(_mm_loadu_ps(&targets.z[i]), voz);
+            const __m128 tca = _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx, vdx), _mm_mul_ps(ly, vdy)), _mm_mul_ps(lz, vdz));
+            const __m128 l2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx, lx), _mm_mul_ps(ly, ly)), _mm_mul_ps(lz, lz));
+            const __m128 d2 = _mm_sub_ps(l2, _mm_mul_ps(tca, tca));
+            const __m128 thc = _mm_sqrt_ps(_mm_max_ps(zero, _mm_sub_ps(r2, d2)));
+            const __m128 t0 = _mm_sub_ps(tca, thc);
+            const __m128 t1 = _mm_add_ps(tca, thc);
+            const __m128 t = select(_mm_cmpge_ps(t0, zero), t0, t1);
+            __m128 hit = _mm_and_ps(_mm_cmpge_ps(tca, zero), _mm_cmple_ps(d2, r2));
+            hit = _mm_and_ps(hit, _mm_cmple_ps(t, vmax));
+            hit = _mm_and_ps(hit, _mm_cmplt_ps(t, best));
+            best = select(hit, t, best);
+            bestSlot = select(hit, lane, bestSlot);
+            lane = _mm_add_ps(lane, four);
+        }
+        PelletHit h{kPelletMiss, 0.0f};
+        _mm_store_ps(dist, best);
+        _mm_store_ps(slot, bestSlot);
+        reduceLanes(dist, slot, 4, h);
+        scanScalar(ox, oy, oz, dx[p], dy[p], dz[p], targets, blocks, n, radius, maxDist, h);
+        out[p] = h;
+    }
+}
+#endif
+} // namespace
+
+void nearestPelletHitsScalar(float ox, float oy, float oz, const float *dx, const float *dy, const float *dz,
+                             int count, const SphereTargets &targets, float radius, float maxDist, PelletHit *out) {
+    for (int p = 0; p < count; ++p) {
+        PelletHit h{kPelletMiss, 0.0f};
+        scanScalar(ox, oy, oz, dx[p], dy[p], dz[p], targets, 0, targets.size(), radius, maxDist, h);
+        out[p] = h;
+    }
+}
+
+void nearestPelletHits(float ox, float oy, float oz, const float *dx, const float *dy, const float *dz, int count,
+                       const SphereTargets &targets, float radius, float maxDist, PelletHit *out) {
+#if defined(PELLET_KERNEL_SSE2)
+    nearestSse2(ox, oy, oz, dx, dy, dz, count, targets, radius, maxDist, out);
+#else
+    nearestPelletHitsScalar(ox, oy, oz, dx, dy, dz, count, targets, radius, maxDist, out);
+#endif
+}
+
+const char *pelletKernelName() {
+#if defined(PELLET_KERNEL_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,76 @@
+#ifndef PELLET_KERNEL_H
+#define PELLET_KERNEL_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Sphere targets in structure-of-arrays form so the kernel can load 4 or 8
+// centers per instruction. index is the caller's id for each sphere.
+struct SphereTargets {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<uint32_t> index;
+
+    void clear() {
+        x.clear();
+        y.clear();
+        z.clear();
+        index.clear();
+    }
+    void push(uint32_t id, float cx, float cy, float cz) {
+        x.push_back(cx);
+        y.push_back(cy);
+        z.push_back(cz);
+        index.push_back(id);
+    }
+    size_t size() const { return index.size(); }
+};
+
+// Nearest hit of one pellet: slot in the SphereTargets, or kPelletMiss.
+struct PelletHit {
+    int32_t target;
+    float dist;
+};
+
+constexpr int32_t kPelletMiss = -1;
+
+// Unit ray (o, d) against a sphere; entry distance, or the exit distance when
+// the origin is inside. Fails for spheres behind the origin or beyond maxDist.
+inline bool raySphereIntersect(const float ox, const float oy, const float oz,
+                               const float dx, const float dy, const float dz,
+                               const float cx, const float cy, const float cz,
+                               const float radius, float maxDist, float &hitDist) {
+    const float lx = cx - ox;
+    const float ly = cy - oy;
+    const float lz = cz - oz;
+    const float tca = lx * dx + ly * dy + lz * dz;
+    if (tca < 0.0f) return false;
+    const float d2 = lx * lx + ly * ly + lz * lz - tca * tca;
+    const float r2 = radius * radius;
+    if (d2 > r2) return false;
+    const float thc = std::sqrt(std::max(0.0f, r2 - d2));
+    const float t0 = tca - thc;
+    const float t1 = tca + thc;
+    const float tHit = (t0 >= 0.0f) ? t0 : t1;
+    hitDist = tHit;
+    return tHit >= 0.0f && tHit <= maxDist;
+}
+
+// For each of count unit directions (dx, dy, dz) from a shared origin, finds
+// the nearest sphere of equal radius it hits within maxDist. Ties go to the
+// lower target slot. Uses SSE2 where the target has it, else scalar; both
+// return the same hits.
+void nearestPelletHits(float ox, float oy, float oz, const float *dx, const float *dy, const float *dz, int count,
+                       const SphereTargets &targets, float radius, float maxDist, PelletHit *out);
+
+// Plain loop over raySphereIntersect, the reference for the SIMD paths.
+void nearestPelletHitsScalar(float ox, float oy, float oz, const float *dx, const float *dy, const float *dz,
+                             int count, const SphereTargets &targets, float radius, float maxDist, PelletHit *out);
+
+// "sse2" or "scalar".
+const char *pelletKernelName();
+
+#endif
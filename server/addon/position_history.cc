@@ -0,0 +1,64 @@
+#include "position_history.h"
+
+#include <algorithm>
+
+namespace {
+constexpr float kScaleY = 256.0f; // 4 mm steps over +-128 m
+
+// Round half away from zero without std::round, so record() vectorizes.
+int16_t quantize(float v, float scale) {
+    const float q = std::max(-32767.0f, std::min(32767.0f, v * scale));
+    return static_cast<int16_t>(static_cast<int32_t>(q + (q >= 0.0f ? 0.5f : -0.5f)));
+}
+} // namespace
+
+void PositionHistory::reset(uint32_t maxSlots, float halfExtent) {
+    samples_.assign(static_cast<size_t>(maxSlots) * kDepth, Sample{});
+    since_.assign(maxSlots, 0);
+    // A little margin: players pressed against the border walls can sit just outside.
+    scaleXZ_ = 32767.0f / (halfExtent + 2.0f);
+    clear();
+}
+
+void PositionHistory::clear() {
+    latest_ = 0;
+    slots_ = 0;
+}
+
+void PositionHistory::restart(uint32_t slot, uint32_t tick) {
+    if (slot >= since_.size()) return;
+    since_[slot] = tick;
+    slots_ = std::max(slots_, slot + 1);
+}
+
+void PositionHistory::removeSwap(uint32_t slot) {
+    if (slot >= slots_) return;
+    const uint32_t last = slots_ - 1;
+    if (slot != last) {
+        for (uint32_t row = 0; row < kDepth; ++row) sample(row, slot) = sample(row, last);
+        since_[slot] = since_[last];
+    }
+    slots_ = last;
+}
+
+void PositionHistory::record(uint32_t tick, uint32_t count, const float *x, const float *y, const float *z) {
+    count = std::min<uint32_t>(count, static_cast<uint32_t>(since_.size()));
+    if (count == 0) return;
+    Sample *row = &sample(tick, 0);
+    for (uint32_t i = 0; i < count; ++i) {
+        Sample &s = row[i];
+        s.x = quantize(x[i], scaleXZ_);
+        s.y = quantize(y[i], kScaleY);
+        s.z = quantize(z[i], scaleXZ_);
+    }
+    latest_ = tick;
+}
+
+bool PositionHistory::at(uint32_t slot, uint32_t tick, float &x, float &y, float &z) const {
+    if (slot >= slots_ || tick > latest_ || latest_ - tick >= kDepth || tick < since_[slot]) return false;
+    const Sample &s = sample(tick, slot);
+    x = static_cast<float>(s.x) / scaleXZ_;
+    y = static_cast<float>(s.y) / kScaleY;
+    z = static_cast<float>(s.z) / scaleXZ_;
+    return true;
+}
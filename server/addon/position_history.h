@@ -0,0 +1,46 @@
+#ifndef POSITION_HISTORY_H
+#define POSITION_HISTORY_H
+
+#include <cstdint>
+#include <vector>
+
+// Recent positions of every player slot, one entry per tick in a per-slot
+// ring, so shots can be resolved against what the shooter saw (lag
+// compensation). Positions are 16-bit fixed point: 6 bytes per slot per tick.
+// Slots follow PlayerStore, including its swap-remove. Storage is tick-major
+// so the per-tick record is one contiguous write.
+class PositionHistory {
+public:
+    static constexpr uint32_t kDepth = 32; // ticks kept per slot, a power of two
+
+    void reset(uint32_t maxSlots, float halfExtent);
+    void clear();
+    // The slot's player appeared (joined or respawned) and is first recorded
+    // at tick; nothing earlier is reported for it.
+    void restart(uint32_t slot, uint32_t tick);
+    void removeSwap(uint32_t slot);
+    // Positions of slots [0, count) as of tick.
+    void record(uint32_t tick, uint32_t count, const float *x, const float *y, const float *z);
+    // Slot position at tick; false if the slot was not recorded then.
+    bool at(uint32_t slot, uint32_t tick, float &x, float &y, float &z) const;
+
+private:
+    struct Sample {
+        int16_t x;
+        int16_t y;
+        int16_t z;
+    };
+
+    Sample &sample(uint32_t tick, uint32_t slot) { return samples_[(tick & (kDepth - 1)) * since_.size() + slot]; }
+    const Sample &sample(uint32_t tick, uint32_t slot) const {
+        return samples_[(tick & (kDepth - 1)) * since_.size() + slot];
+    }
+
+    std::vector<Sample> samples_; // kDepth rows of one sample per slot
+    std::vector<uint32_t> since_; // per slot: first recorded tick
+    uint32_t latest_ = 0;
+    uint32_t slots_ = 0;
+    float scaleXZ_ = 1.0f;
+};
+
+#endif
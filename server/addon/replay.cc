@@ -0,0 +1,34 @@
+#include "replay.h"
+#include "game_server.h"
+
+#include <chrono>
+#include <memory>
+
+ReplayResult replayInputLog(const std::string &path) {
+    ReplayResult result;
+    InputLogReader reader;
+    if (!reader.open(path)) return result;
+    result.opened = true;
+
+    const InputLogHeader &header = reader.header();
+    GameConfig config{header.maxPlayers, header.worldHalfExtent, header.botCount, header.snapshotPrecision};
+    config.inputBufferDepth = header.inputBufferDepth;
+    config.maxRewindTicks = header.maxRewindTicks;
+    config.seed = header.seed;
+    config.mapPath = header.mapPath;
+    auto server = std::make_unique<GameServer>();
+    server->startHeadless(config);
+
+    const auto start = std::chrono::steady_clock::now();
+    InputLogTick tick;
+    while (reader.next(tick)) {
+        server->stepReplay(tick.inputs, tick.dt);
+        ++result.ticks;
+        result.inputs += tick.inputs.size();
+        if (server->stateHash() != tick.stateHash) {
+            if (result.mismatches++ == 0) result.firstMismatchTick = tick.tick;
+        }
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
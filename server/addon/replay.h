@@ -0,0 +1,20 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <string>
+
+struct ReplayResult {
+    bool opened = false;
+    uint32_t ticks = 0;
+    uint64_t inputs = 0;
+    uint32_t mismatches = 0;        // ticks whose state hash differed from the log
+    uint32_t firstMismatchTick = 0; // 0 if none
+    double seconds = 0.0;
+};
+
+// Re-runs a room recorded with GameConfig::recordPath on a headless server,
+// as fast as the CPU allows, and checks the state hash after every tick.
+ReplayResult replayInputLog(const std::string &path);
+
+#endif
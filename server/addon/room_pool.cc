@@ -0,0 +1,138 @@
+#include "room_pool.h"
+
+#include <algorithm>
+
+namespace {
+template <typename Ptr>
+bool laterDeadline(const Ptr &a, const Ptr &b) {
+    return a->wake() > b->wake();
+}
+} // namespace
+
+RoomPool::RoomPool(unsigned workers) {
+    if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+    workers_.reserve(workers);
+    for (unsigned i = 0; i < workers; ++i) {
+        workers_.emplace_back(&RoomPool::workerLoop, this);
+    }
+}
+
+RoomPool::~RoomPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread &worker : workers_) worker.join();
+}
+
+RoomPool::Handle RoomPool::create(const GameConfig &config, double tickHz, const SchedulerConfig &scheduler) {
+    auto room = std::make_shared<Room>();
+    room->server.startHeadless(config);
+    room->scheduler = scheduler;
+    room->spin = scheduler.wait == TickWait::Hybrid ? clock::duration(scheduler.spinWindow) : clock::duration::zero();
+    room->schedule.period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / tickHz));
+    room->schedule.deadline = clock::now() + room->schedule.period;
+    room->dt = static_cast<float>(1.0 / tickHz);
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (nextHandle_ == kNoRoom || rooms_.count(nextHandle_)) ++nextHandle_;
+    room->handle = nextHandle_++;
+    rooms_.emplace(room->handle, room);
+    schedule(room);
+    return room->handle;
+}
+
+bool RoomPool::destroy(Handle handle) {
+    std::shared_ptr<Room> room;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = rooms_.find(handle);
+        if (it == rooms_.end()) return false;
+        room = it->second;
+        rooms_.erase(it);
+        // A worker stepping the room right now sees closed, drops it and
+        // stops it afterwards.
+        room->closed = true;
+        auto queued = std::find(queue_.begin(), queue_.end(), room);
+        if (queued == queue_.end()) return true;
+        queue_.erase(queued);
+        std::make_heap(queue_.begin(), queue_.end(), laterDeadline<std::shared_ptr<Room>>);
+    }
+    // Flushes its input log now; JS buffers may keep the room itself alive for long.
+    room->server.stop();
+    return true;
+}
+
+std::shared_ptr<GameServer> RoomPool::find(Handle handle) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = rooms_.find(handle);
+    if (it == rooms_.end()) return nullptr;
+    return std::shared_ptr<GameServer>(it->second, &it->second->server);
+}
+
+size_t RoomPool::roomCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rooms_.size();
+}
+
+RoomPool::Stats RoomPool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void RoomPool::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_ = Stats{};
+}
+
+void RoomPool::schedule(const std::shared_ptr<Room> &room) {
+    const bool earliest = queue_.empty() || room->wake() < queue_.front()->wake();
+    queue_.push_back(room);
+    std::push_heap(queue_.begin(), queue_.end(), laterDeadline<std::shared_ptr<Room>>);
+    // Sleeping workers wait for the old front deadline; wake one to re-arm.
+    if (earliest) wake_.notify_one();
+}
+
+void RoomPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        if (queue_.empty()) {
+            wake_.wait(lock);
+            continue;
+        }
+        const clock::time_point wake = queue_.front()->wake();
+        if (clock::now() < wake) {
+            wake_.wait_until(lock, wake);
+            continue;
+        }
+        std::pop_heap(queue_.begin(), queue_.end(), laterDeadline<std::shared_ptr<Room>>);
+        std::shared_ptr<Room> room = std::move(queue_.back());
+        queue_.pop_back();
+        // Another room may already be due; let a second worker take it.
+        if (!queue_.empty() && queue_.front()->wake() <= clock::now()) wake_.notify_one();
+
+        lock.unlock();
+        if (room->spin != clock::duration::zero()) hybridWaitUntil(room->schedule.deadline, room->spin);
+        const clock::time_point start = clock::now();
+        const clock::duration late = std::max(clock::duration::zero(), start - room->schedule.deadline);
+        const uint64_t lateNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(late).count());
+        room->server.profiler().recordStartLag(lateNs);
+        room->server.step(room->dt);
+        const uint32_t skipped = room->schedule.advance(room->scheduler, clock::now());
+        room->server.profiler().addSkipped(skipped);
+        lock.lock();
+
+        ++stats_.ticks;
+        stats_.totalLateNs += lateNs;
+        stats_.maxLateNs = std::max(stats_.maxLateNs, lateNs);
+        stats_.skippedTicks += skipped;
+        if (late >= room->schedule.period) ++stats_.lateTicks;
+        if (!room->closed) {
+            schedule(room);
+        } else {
+            lock.unlock();
+            room->server.stop();
+            lock.lock();
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef ROOM_POOL_H
+#define ROOM_POOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "game_server.h"
+
+// Many independent rooms ticked by a fixed set of worker threads. Each room
+// has its own next-tick deadline and catch-up policy; idle workers take the
+// room with the earliest due deadline, so a room is only ever stepped by one
+// worker at a time.
+class RoomPool {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle kNoRoom = 0;
+
+    struct Stats {
+        uint64_t ticks = 0;
+        uint64_t lateTicks = 0;    // started a full period or more after their deadline
+        uint64_t totalLateNs = 0;  // summed start lateness
+        uint64_t maxLateNs = 0;
+        uint64_t skippedTicks = 0; // slots given up by the rooms' catch-up policies
+    };
+
+    // workers == 0 uses one thread per hardware thread.
+    explicit RoomPool(unsigned workers = 0);
+    ~RoomPool();
+    RoomPool(const RoomPool &) = delete;
+    RoomPool &operator=(const RoomPool &) = delete;
+
+    // TickWait::TimerFd is treated as Sleep here: workers already block on a
+    // condition variable until the earliest deadline.
+    Handle create(const GameConfig &config, double tickHz = 60.0, const SchedulerConfig &scheduler = {});
+    bool destroy(Handle handle);
+    // Keeps the room alive while held, even past destroy().
+    std::shared_ptr<GameServer> find(Handle handle) const;
+
+    size_t roomCount() const;
+    unsigned workerCount() const { return static_cast<unsigned>(workers_.size()); }
+    Stats stats() const;
+    void resetStats();
+
+private:
+    using clock = TickClock;
+
+    struct Room {
+        Handle handle = kNoRoom;
+        GameServer server;
+        SchedulerConfig scheduler;
+        TickSchedule schedule;
+        clock::duration spin{}; // hybrid spin window, zero when sleeping
+        float dt = 0.0f;
+        bool closed = false;
+
+        clock::time_point wake() const { return schedule.deadline - spin; }
+    };
+
+    void workerLoop();
+    void schedule(const std::shared_ptr<Room> &room);
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::unordered_map<Handle, std::shared_ptr<Room>> rooms_;
+    std::vector<std::shared_ptr<Room>> queue_; // min-heap on deadline; rooms being stepped are not in it
+    Handle nextHandle_ = 1;
+    bool stopping_ = false;
+    Stats stats_;
+    std::vector<std::thread> workers_;
+};
+
+#endif
@@ -0,0 +1,114 @@
+#include "snapshot_buffer.h"
+
+#include <algorithm>
+
+SnapshotView &SnapshotView::operator=(SnapshotView &&other) noexcept {
+    if (this != &other) {
+        reset();
+        frame_ = other.frame_;
+        other.frame_ = nullptr;
+    }
+    return *this;
+}
+
+void SnapshotView::reset() {
+    if (frame_) {
+        SnapshotPublisher::release(frame_);
+        frame_ = nullptr;
+    }
+}
+
+SnapshotSlice SnapshotView::sliceFor(uint32_t clientId) const {
+    if (!frame_) return SnapshotSlice{0, 0, 0};
+    if (clientId == 0) return frame_->full;
+    const auto &clients = frame_->clients;
+    auto it = std::lower_bound(clients.begin(), clients.end(), clientId,
+                               [](const SnapshotSlice &s, uint32_t id) { return s.clientId < id; });
+    if (it != clients.end() && it->clientId == clientId) return *it;
+    return frame_->full;
+}
+
+SnapshotPublisher::SnapshotPublisher() : latest_(nullptr) {
+    // Latest + one being written + a few pinned by readers covers steady state.
+    for (size_t i = 0; i < kKeptFrames; ++i) {
+        frames_.push_back(std::make_unique<SnapshotFrame>());
+    }
+    active_ = frames_.size();
+}
+
+SnapshotPublisher::~SnapshotPublisher() { clear(); }
+
+SnapshotFrame *SnapshotPublisher::beginFrame() {
+    if (active_ > kKeptFrames && ++sinceTrim_ >= kTrimInterval) {
+        sinceTrim_ = 0;
+        trimIdle();
+    }
+    for (size_t i = 0; i < active_; ++i) {
+        SnapshotFrame *frame = frames_[(cursor_ + i) % active_].get();
+        uint32_t expected = 0;
+        if (frame->refs.compare_exchange_strong(expected, kWriterBit, std::memory_order_acquire)) {
+            cursor_ = (cursor_ + i + 1) % active_;
+            return frame;
+        }
+    }
+    // Every frame is pinned by a slow reader; grow rather than block.
+    if (active_ == frames_.size()) frames_.push_back(std::make_unique<SnapshotFrame>());
+    SnapshotFrame *frame = frames_[active_++].get();
+    // A spare may still see a stray increment from a reader that raced its
+    // recycle; adding keeps it, as publish() does.
+    frame->refs.fetch_add(kWriterBit, std::memory_order_acquire);
+    return frame;
+}
+
+// Frame objects are never freed, since a reader in acquire() may still touch
+// one it saw as latest; only their buffers are. Claiming a frame with the
+// writer bit first makes such a reader back off without reading the data.
+void SnapshotPublisher::trimIdle() {
+    for (size_t i = active_; i-- > 0 && active_ > kKeptFrames;) {
+        SnapshotFrame *frame = frames_[i].get();
+        uint32_t expected = 0;
+        if (!frame->refs.compare_exchange_strong(expected, kWriterBit, std::memory_order_acquire)) continue;
+        std::vector<uint8_t>().swap(frame->data);
+        std::vector<SnapshotSlice>().swap(frame->clients);
+        frame->refs.fetch_sub(kWriterBit, std::memory_order_release);
+        std::swap(frames_[i], frames_[--active_]);
+    }
+    cursor_ %= active_;
+}
+
+void SnapshotPublisher::publish(SnapshotFrame *frame) {
+    // Trade the writer bit for the publisher's reference while keeping any
+    // transient reader increments that raced in.
+    frame->refs.fetch_sub(kWriterBit - 1, std::memory_order_release);
+    SnapshotFrame *old = latest_.exchange(frame, std::memory_order_acq_rel);
+    if (old) release(old);
+}
+
+void SnapshotPublisher::clear() {
+    SnapshotFrame *old = latest_.exchange(nullptr, std::memory_order_acq_rel);
+    if (old) release(old);
+}
+
+size_t SnapshotPublisher::retainedBytes() const {
+    size_t bytes = 0;
+    for (const auto &frame : frames_) bytes += frame->data.capacity();
+    return bytes;
+}
+
+SnapshotView SnapshotPublisher::acquire() const {
+    for (;;) {
+        SnapshotFrame *frame = latest_.load(std::memory_order_acquire);
+        if (!frame) return SnapshotView();
+        const uint32_t prev = frame->refs.fetch_add(1, std::memory_order_acquire);
+        // A free or in-progress frame means we raced a recycle; retry on the new latest.
+        if (prev != 0 && (prev & kWriterBit) == 0 &&
+            latest_.load(std::memory_order_acquire) == frame) {
+            return SnapshotView(frame);
+        }
+        release(frame);
+    }
+}
+
+void SnapshotPublisher::release(SnapshotFrame *frame) {
+    frame->refs.fetch_sub(1, std::memory_order_release);
+}
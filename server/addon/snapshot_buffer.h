@@ -0,0 +1,98 @@
+#ifndef SNAPSHOT_BUFFER_H
+#define SNAPSHOT_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Byte range inside a frame's data.
+struct SnapshotSlice {
+    uint32_t clientId;
+    uint32_t offset;
+    uint32_t size;
+};
+
+// Immutable once published. refs counts readers plus one reference held by the
+// publisher while the frame is the latest; the frame is recycled at zero.
+// data holds the full snapshot (full) followed by per-client deltas (clients,
+// sorted by clientId).
+struct SnapshotFrame {
+    std::atomic<uint32_t> refs{0};
+    uint32_t tick = 0;
+    std::vector<uint8_t> data;
+    SnapshotSlice full{0, 0, 0};
+    std::vector<SnapshotSlice> clients;
+};
+
+// Move-only read handle on a published frame. Never blocks the tick thread.
+class SnapshotView {
+public:
+    SnapshotView() = default;
+    explicit SnapshotView(SnapshotFrame *frame) : frame_(frame) {}
+    SnapshotView(SnapshotView &&other) noexcept : frame_(other.frame_) { other.frame_ = nullptr; }
+    SnapshotView &operator=(SnapshotView &&other) noexcept;
+    SnapshotView(const SnapshotView &) = delete;
+    SnapshotView &operator=(const SnapshotView &) = delete;
+    ~SnapshotView() { reset(); }
+
+    void reset();
+    // Hands the reference to the caller, who must pass it to SnapshotPublisher::release.
+    SnapshotFrame *detach() {
+        SnapshotFrame *frame = frame_;
+        frame_ = nullptr;
+        return frame;
+    }
+    const SnapshotFrame *frame() const { return frame_; }
+    bool empty() const { return frame_ == nullptr || frame_->full.size == 0; }
+    const uint8_t *data() const { return frame_ ? frame_->data.data() + frame_->full.offset : nullptr; }
+    size_t size() const { return frame_ ? frame_->full.size : 0; }
+    uint32_t tick() const { return frame_ ? frame_->tick : 0; }
+    // The client's delta, or the full snapshot (clientId 0) if the frame has none for it.
+    SnapshotSlice sliceFor(uint32_t clientId) const;
+
+private:
+    SnapshotFrame *frame_ = nullptr;
+};
+
+// Single-writer, many-reader publication of snapshot frames. The tick thread
+// fills a free frame and swaps it in as the latest; readers pin the latest
+// frame with a refcount instead of copying it under a lock.
+class SnapshotPublisher {
+public:
+    SnapshotPublisher();
+    ~SnapshotPublisher();
+    SnapshotPublisher(const SnapshotPublisher &) = delete;
+    SnapshotPublisher &operator=(const SnapshotPublisher &) = delete;
+
+    // Writer side (tick thread only).
+    SnapshotFrame *beginFrame();
+    void publish(SnapshotFrame *frame);
+    void clear();
+    // Frame buffer bytes held by the pool, pinned or not.
+    size_t retainedBytes() const;
+
+    // Reader side (any thread). Views must not outlive the publisher.
+    SnapshotView acquire() const;
+
+    static void release(SnapshotFrame *frame);
+
+private:
+    static constexpr uint32_t kWriterBit = 1u << 31;
+    static constexpr size_t kKeptFrames = 4;
+    static constexpr uint32_t kTrimInterval = 64; // frames published between trims of a grown pool
+
+    // Moves idle frames out of the rotation, freeing their buffers, until
+    // only kKeptFrames remain or the rest are pinned.
+    void trimIdle();
+
+    // frames_[0, active_) rotate; the rest are spares without buffers.
+    std::vector<std::unique_ptr<SnapshotFrame>> frames_;
+    size_t active_ = 0;
+    size_t cursor_ = 0;
+    uint32_t sinceTrim_ = 0;
+    std::atomic<SnapshotFrame *> latest_;
+};
+
+#endif
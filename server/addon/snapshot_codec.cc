@@ -0,0 +1,276 @@
+#include "snapshot_codec.h"
+#include "bit_stream.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+constexpr float kPi = 3.14159265358979323846f;
+
+uint32_t quantizeLinear(float v, float lo, float hi, uint8_t bits) {
+    const double maxQ = static_cast<double>((1ull << bits) - 1);
+    double t = (static_cast<double>(v) - lo) / (static_cast<double>(hi) - lo);
+    t = std::max(0.0, std::min(1.0, t));
+    return static_cast<uint32_t>(t * maxQ + 0.5);
+}
+
+float dequantizeLinear(uint32_t q, float lo, float hi, uint8_t bits) {
+    const double maxQ = static_cast<double>((1ull << bits) - 1);
+    return static_cast<float>(lo + (static_cast<double>(hi) - lo) * (q / maxQ));
+}
+
+// Angles wrap, so the full 2^bits codes cover one turn with no duplicate endpoint.
+uint32_t quantizeAngle(float v, float lo, float span, uint8_t bits) {
+    double t = (static_cast<double>(v) - lo) / span;
+    t -= std::floor(t);
+    const uint64_t steps = 1ull << bits;
+    return static_cast<uint32_t>(static_cast<uint64_t>(t * static_cast<double>(steps) + 0.5) & (steps - 1));
+}
+
+float dequantizeAngle(uint32_t q, float lo, float span, uint8_t bits) {
+    return static_cast<float>(lo + static_cast<double>(span) * q / static_cast<double>(1ull << bits));
+}
+
+uint8_t clampBits(uint8_t bits) {
+    return static_cast<uint8_t>(std::max<int>(1, std::min<int>(24, bits)));
+}
+
+uint32_t floatBits(float v) {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+float bitsFloat(uint32_t bits) {
+    float v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+void writeFields(BitWriter &w, const SnapshotPrecision &prec, const EntitySnapshot &e, uint16_t mask) {
+    w.write(mask, kSnapshotFieldCount);
+    if (mask & kFieldX) w.write(e.x, prec.positionBits);
+    if (mask & kFieldY) w.write(e.y, prec.positionBits);
+    if (mask & kFieldZ) w.write(e.z, prec.positionBits);
+    if (mask & kFieldVx) w.write(e.vx, prec.velocityBits);
+    if (mask & kFieldVy) w.write(e.vy, prec.velocityBits);
+    if (mask & kFieldVz) w.write(e.vz, prec.velocityBits);
+    if (mask & kFieldYaw) w.write(e.yaw, prec.yawBits);
+    if (mask & kFieldPitch) w.write(e.pitch, prec.pitchBits);
+    if (mask & kFieldHealth) w.write(e.health, 8);
+    if (mask & kFieldActive) w.write(e.active, 1);
+    if (mask & kFieldIsBot) w.write(e.isBot, 1);
+    if (mask & kFieldWeapon) w.write(e.weapon, 8);
+    if (mask & kFieldLastSeq) w.writeVar(e.lastSeq);
+}
+
+void readFields(BitReader &r, const SnapshotPrecision &prec, EntitySnapshot &e) {
+    const uint16_t mask = static_cast<uint16_t>(r.read(kSnapshotFieldCount));
+    if (mask & kFieldX) e.x = r.read(prec.positionBits);
+    if (mask & kFieldY) e.y = r.read(prec.positionBits);
+    if (mask & kFieldZ) e.z = r.read(prec.positionBits);
+    if (mask & kFieldVx) e.vx = r.read(prec.velocityBits);
+    if (mask & kFieldVy) e.vy = r.read(prec.velocityBits);
+    if (mask & kFieldVz) e.vz = r.read(prec.velocityBits);
+    if (mask & kFieldYaw) e.yaw = r.read(prec.yawBits);
+    if (mask & kFieldPitch) e.pitch = r.read(prec.pitchBits);
+    if (mask & kFieldHealth) e.health = static_cast<uint8_t>(r.read(8));
+    if (mask & kFieldActive) e.active = static_cast<uint8_t>(r.read(1));
+    if (mask & kFieldIsBot) e.isBot = static_cast<uint8_t>(r.read(1));
+    if (mask & kFieldWeapon) e.weapon = static_cast<uint8_t>(r.read(8));
+    if (mask & kFieldLastSeq) e.lastSeq = r.readVar();
+}
+
+bool lessById(const EntitySnapshot &e, uint32_t id) { return e.id < id; }
+} // namespace
+
+SnapshotQuantizer::SnapshotQuantizer(const SnapshotPrecision &precision, float worldHalfExtent)
+    : worldHalfExtent_(worldHalfExtent) {
+    precision_.positionBits = clampBits(precision.positionBits);
+    precision_.velocityBits = clampBits(precision.velocityBits);
+    precision_.yawBits = clampBits(precision.yawBits);
+    precision_.pitchBits = clampBits(precision.pitchBits);
+}
+
+uint32_t SnapshotQuantizer::position(float v) const {
+    return quantizeLinear(v, -worldHalfExtent_, worldHalfExtent_, precision_.positionBits);
+}
+
+uint32_t SnapshotQuantizer::height(float v) const {
+    return quantizeLinear(v, kSnapshotMinY, kSnapshotMaxY, precision_.positionBits);
+}
+
+uint32_t SnapshotQuantizer::velocity(float v) const {
+    return quantizeLinear(v, -kSnapshotMaxVelocity, kSnapshotMaxVelocity, precision_.velocityBits);
+}
+
+uint32_t SnapshotQuantizer::yaw(float v) const {
+    return quantizeAngle(v, -kPi, 2.0f * kPi, precision_.yawBits);
+}
+
+uint32_t SnapshotQuantizer::pitch(float v) const {
+    return quantizeLinear(v, -0.5f * kPi, 0.5f * kPi, precision_.pitchBits);
+}
+
+float SnapshotQuantizer::positionValue(uint32_t q) const {
+    return dequantizeLinear(q, -worldHalfExtent_, worldHalfExtent_, precision_.positionBits);
+}
+
+float SnapshotQuantizer::heightValue(uint32_t q) const {
+    return dequantizeLinear(q, kSnapshotMinY, kSnapshotMaxY, precision_.positionBits);
+}
+
+float SnapshotQuantizer::velocityValue(uint32_t q) const {
+    return dequantizeLinear(q, -kSnapshotMaxVelocity, kSnapshotMaxVelocity, precision_.velocityBits);
+}
+
+float SnapshotQuantizer::yawValue(uint32_t q) const {
+    return dequantizeAngle(q, -kPi, 2.0f * kPi, precision_.yawBits);
+}
+
+float SnapshotQuantizer::pitchValue(uint32_t q) const {
+    return dequantizeLinear(q, -0.5f * kPi, 0.5f * kPi, precision_.pitchBits);
+}
+
+std::vector<EntitySnapshot> &SnapshotHistory::begin(uint32_t tick) {
+    Entry &entry = entries_[tick % kTicks];
+    entry.tick = tick;
+    entry.valid = true;
+    entry.entities.clear();
+    return entry.entities;
+}
+
+const std::vector<EntitySnapshot> *SnapshotHistory::find(uint32_t tick) const {
+    const Entry &entry = entries_[tick % kTicks];
+    if (!entry.valid || entry.tick != tick) return nullptr;
+    return &entry.entities;
+}
+
+void SnapshotHistory::clear() {
+    for (auto &entry : entries_) {
+        entry.valid = false;
+        entry.entities.clear();
+    }
+}
+
+uint16_t diffFields(const EntitySnapshot &base, const EntitySnapshot &current) {
+    uint16_t mask = 0;
+    if (base.x != current.x) mask |= kFieldX;
+    if (base.y != current.y) mask |= kFieldY;
+    if (base.z != current.z) mask |= kFieldZ;
+    if (base.vx != current.vx) mask |= kFieldVx;
+    if (base.vy != current.vy) mask |= kFieldVy;
+    if (base.vz != current.vz) mask |= kFieldVz;
+    if (base.yaw != current.yaw) mask |= kFieldYaw;
+    if (base.pitch != current.pitch) mask |= kFieldPitch;
+    if (base.health != current.health) mask |= kFieldHealth;
+    if (base.active != current.active) mask |= kFieldActive;
+    if (base.isBot != current.isBot) mask |= kFieldIsBot;
+    if (base.weapon != current.weapon) mask |= kFieldWeapon;
+    if (base.lastSeq != current.lastSeq) mask |= kFieldLastSeq;
+    return mask;
+}
+
+void encodeSnapshot(uint32_t tick, uint32_t baseTick, const SnapshotQuantizer &quantizer,
+                    const std::vector<EntitySnapshot> *base, const std::vector<EntitySnapshot> &current,
+                    uint32_t viewerId, std::vector<uint8_t> &out) {
+    if (!base) baseTick = 0;
+    const SnapshotPrecision &prec = quantizer.precision();
+    BitWriter w(out);
+    w.write(kSnapshotVersion, 8);
+    w.write(tick, 32);
+    w.write(baseTick, 32);
+    w.write(prec.positionBits, 5);
+    w.write(prec.velocityBits, 5);
+    w.write(prec.yawBits, 5);
+    w.write(prec.pitchBits, 5);
+    w.write(floatBits(quantizer.worldHalfExtent()), 32);
+
+    auto ownSeqOnly = [viewerId](const EntitySnapshot &e) {
+        return viewerId != 0 && e.id != viewerId;
+    };
+
+    // Both lists are sorted by id, so one merge pass finds removals and matches.
+    // Lists are id-delta coded and terminated by a cleared continuation bit.
+    if (base) {
+        uint32_t prevId = 0;
+        size_t c = 0;
+        for (const auto &b : *base) {
+            while (c < current.size() && current[c].id < b.id) ++c;
+            if (c == current.size() || current[c].id != b.id) {
+                w.writeBool(true);
+                w.writeVar(b.id - prevId);
+                prevId = b.id;
+            }
+        }
+    }
+    w.writeBool(false);
+
+    uint32_t prevId = 0;
+    size_t b = 0;
+    for (const auto &e : current) {
+        uint16_t mask = kFieldAll;
+        if (base) {
+            while (b < base->size() && (*base)[b].id < e.id) ++b;
+            if (b < base->size() && (*base)[b].id == e.id) {
+                mask = diffFields((*base)[b], e);
+                if (ownSeqOnly(e)) mask &= static_cast<uint16_t>(~kFieldLastSeq);
+                if (mask == 0) continue;
+            }
+        }
+        w.writeBool(true);
+        w.writeVar(e.id - prevId);
+        prevId = e.id;
+        if (ownSeqOnly(e) && mask == kFieldAll) {
+            EntitySnapshot masked = e;
+            masked.lastSeq = 0;
+            writeFields(w, prec, masked, mask);
+        } else {
+            writeFields(w, prec, e, mask);
+        }
+    }
+    w.writeBool(false);
+    w.flush();
+}
+
+bool decodeSnapshot(const uint8_t *data, size_t size, const SnapshotHistory &history,
+                    SnapshotHeader &header, std::vector<EntitySnapshot> &out) {
+    BitReader r(data, size);
+    header.version = static_cast<uint8_t>(r.read(8));
+    if (header.version != kSnapshotVersion) return false;
+    header.tick = r.read(32);
+    header.baseTick = r.read(32);
+    SnapshotPrecision prec;
+    prec.positionBits = static_cast<uint8_t>(r.read(5));
+    prec.velocityBits = static_cast<uint8_t>(r.read(5));
+    prec.yawBits = static_cast<uint8_t>(r.read(5));
+    prec.pitchBits = static_cast<uint8_t>(r.read(5));
+    header.quantizer = SnapshotQuantizer(prec, bitsFloat(r.read(32)));
+
+    out.clear();
+    if (header.baseTick != 0) {
+        const std::vector<EntitySnapshot> *base = history.find(header.baseTick);
+        if (!base) return false;
+        out = *base;
+    }
+
+    uint32_t id = 0;
+    while (r.readBool() && !r.overflowed()) {
+        id += r.readVar();
+        auto it = std::lower_bound(out.begin(), out.end(), id, lessById);
+        if (it != out.end() && it->id == id) out.erase(it);
+    }
+    id = 0;
+    while (r.readBool() && !r.overflowed()) {
+        id += r.readVar();
+        auto it = std::lower_bound(out.begin(), out.end(), id, lessById);
+        if (it == out.end() || it->id != id) {
+            EntitySnapshot fresh{};
+            fresh.id = id;
+            it = out.insert(it, fresh);
+        }
+        readFields(r, header.quantizer.precision(), *it);
+    }
+    return !r.overflowed();
+}
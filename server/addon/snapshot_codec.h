@@ -0,0 +1,128 @@
+#ifndef SNAPSHOT_CODEC_H
+#define SNAPSHOT_CODEC_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+constexpr uint8_t kSnapshotVersion = 2;
+
+// Bits per quantized field. Positions span the world (x/z) or kSnapshotMinY..MaxY
+// (y), velocities +-kSnapshotMaxVelocity, yaw a full turn, pitch +-pi/2.
+struct SnapshotPrecision {
+    uint8_t positionBits = 16;
+    uint8_t velocityBits = 12;
+    uint8_t yawBits = 14;
+    uint8_t pitchBits = 12;
+};
+
+constexpr float kSnapshotMinY = -8.0f;
+constexpr float kSnapshotMaxY = 56.0f;
+constexpr float kSnapshotMaxVelocity = 32.0f;
+
+class SnapshotQuantizer {
+public:
+    SnapshotQuantizer() = default;
+    SnapshotQuantizer(const SnapshotPrecision &precision, float worldHalfExtent);
+
+    const SnapshotPrecision &precision() const { return precision_; }
+    float worldHalfExtent() const { return worldHalfExtent_; }
+
+    uint32_t position(float v) const;
+    uint32_t height(float v) const;
+    uint32_t velocity(float v) const;
+    uint32_t yaw(float v) const;
+    uint32_t pitch(float v) const;
+
+    float positionValue(uint32_t q) const;
+    float heightValue(uint32_t q) const;
+    float velocityValue(uint32_t q) const;
+    float yawValue(uint32_t q) const;
+    float pitchValue(uint32_t q) const;
+
+private:
+    SnapshotPrecision precision_;
+    float worldHalfExtent_ = 50.0f;
+};
+
+// Wire-level view of one entity as the client reconstructs it. Continuous
+// fields hold quantized values, so deltas ignore sub-precision noise.
+struct EntitySnapshot {
+    uint32_t id;
+    uint32_t x;
+    uint32_t y;
+    uint32_t z;
+    uint32_t vx;
+    uint32_t vy;
+    uint32_t vz;
+    uint32_t yaw;
+    uint32_t pitch;
+    uint8_t health;
+    uint8_t active;
+    uint8_t isBot;
+    uint8_t weapon;
+    uint32_t lastSeq;
+};
+
+// One bit per field in EntitySnapshot order; set bits are present on the wire.
+enum SnapshotField : uint16_t {
+    kFieldX = 1u << 0,
+    kFieldY = 1u << 1,
+    kFieldZ = 1u << 2,
+    kFieldVx = 1u << 3,
+    kFieldVy = 1u << 4,
+    kFieldVz = 1u << 5,
+    kFieldYaw = 1u << 6,
+    kFieldPitch = 1u << 7,
+    kFieldHealth = 1u << 8,
+    kFieldActive = 1u << 9,
+    kFieldIsBot = 1u << 10,
+    kFieldWeapon = 1u << 11,
+    kFieldLastSeq = 1u << 12,
+    kFieldAll = (1u << 13) - 1,
+};
+constexpr unsigned kSnapshotFieldCount = 13;
+
+// Recent per-tick entity sets (sorted by id) that clients may have acked.
+class SnapshotHistory {
+public:
+    static constexpr uint32_t kTicks = 64;
+
+    std::vector<EntitySnapshot> &begin(uint32_t tick);
+    const std::vector<EntitySnapshot> *find(uint32_t tick) const;
+    void clear();
+
+private:
+    struct Entry {
+        uint32_t tick = 0;
+        bool valid = false;
+        std::vector<EntitySnapshot> entities;
+    };
+    std::array<Entry, kTicks> entries_;
+};
+
+uint16_t diffFields(const EntitySnapshot &base, const EntitySnapshot &current);
+
+// Appends a bit-packed snapshot for viewerId to out. With a baseline, entities
+// whose fields all match are elided and the rest carry only their changed
+// fields; without one (baseTick 0) every field of every entity is written.
+// lastSeq is only tracked for the viewer's own entity (viewerId 0 keeps it for
+// everyone).
+void encodeSnapshot(uint32_t tick, uint32_t baseTick, const SnapshotQuantizer &quantizer,
+                    const std::vector<EntitySnapshot> *base, const std::vector<EntitySnapshot> &current,
+                    uint32_t viewerId, std::vector<uint8_t> &out);
+
+struct SnapshotHeader {
+    uint8_t version;
+    uint32_t tick;
+    uint32_t baseTick;
+    SnapshotQuantizer quantizer;
+};
+
+// Mirror of the client decoder. history must hold the baseline named by the
+// header; returns false on a bad version, missing baseline or truncated data.
+bool decodeSnapshot(const uint8_t *data, size_t size, const SnapshotHistory &history,
+                    SnapshotHeader &header, std::vector<EntitySnapshot> &out);
+
+#endif
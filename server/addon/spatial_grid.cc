@@ -0,0 +1,74 @@
+#include "spatial_grid.h"
+
+void SpatialGrid::reset(float halfExtent, float cellSize) {
+    half_ = halfExtent;
+    cellSize_ = cellSize;
+    invCell_ = 1.0f / cellSize;
+    dim_ = std::max(1, static_cast<int>(std::ceil(2.0f * halfExtent * invCell_)));
+    head_.assign(static_cast<size_t>(dim_) * dim_, kNone);
+    cellStamp_.assign(head_.size(), 0u);
+    stamp_ = 0;
+    next_.clear();
+    prev_.clear();
+    cell_.clear();
+    x_.clear();
+    z_.clear();
+}
+
+void SpatialGrid::clear() {
+    std::fill(head_.begin(), head_.end(), kNone);
+    std::fill(cell_.begin(), cell_.end(), kNone);
+}
+
+void SpatialGrid::insert(uint32_t index, float x, float z) {
+    if (index >= cell_.size()) {
+        const size_t size = static_cast<size_t>(index) + 1;
+        next_.resize(size, kNone);
+        prev_.resize(size, kNone);
+        cell_.resize(size, kNone);
+        x_.resize(size, 0.0f);
+        z_.resize(size, 0.0f);
+    }
+    if (cell_[index] != kNone) unlink(index);
+    x_[index] = x;
+    z_[index] = z;
+    link(index, cellIndex(cellCoord(x), cellCoord(z)));
+}
+
+void SpatialGrid::update(uint32_t index, float x, float z) {
+    if (!contains(index)) {
+        insert(index, x, z);
+        return;
+    }
+    x_[index] = x;
+    z_[index] = z;
+    const uint32_t cell = cellIndex(cellCoord(x), cellCoord(z));
+    if (cell == cell_[index]) return;
+    unlink(index);
+    link(index, cell);
+}
+
+void SpatialGrid::remove(uint32_t index) {
+    if (contains(index)) unlink(index);
+}
+
+void SpatialGrid::link(uint32_t index, uint32_t cell) {
+    const uint32_t first = head_[cell];
+    next_[index] = first;
+    prev_[index] = kNone;
+    if (first != kNone) prev_[first] = index;
+    head_[cell] = index;
+    cell_[index] = cell;
+}
+
+void SpatialGrid::unlink(uint32_t index) {
+    const uint32_t cell = cell_[index];
+    if (prev_[index] != kNone) {
+        next_[prev_[index]] = next_[index];
+    } else {
+        head_[cell] = next_[index];
+    }
+    if (next_[index] != kNone) prev_[next_[index]] = prev_[index];
+    next_[index] = prev_[index] = kNone;
+    cell_[index] = kNone;
+}
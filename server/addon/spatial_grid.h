@@ -0,0 +1,170 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Uniform grid over the XZ square [-halfExtent, halfExtent]. Entities are
+// points (their centers) kept in intrusive per-cell lists, so moving one is
+// O(1) and the grid can be updated as the simulation runs. Indices are the
+// caller's (e.g. player slots). Height is ignored: the map is flat
+// enough that culling on XZ alone removes almost everything.
+class SpatialGrid {
+public:
+    static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+    void reset(float halfExtent, float cellSize);
+    void clear();
+    void insert(uint32_t index, float x, float z);
+    void update(uint32_t index, float x, float z);
+    void remove(uint32_t index);
+    bool contains(uint32_t index) const { return index < cell_.size() && cell_[index] != kNone; }
+    float cellSize() const { return cellSize_; }
+
+    // fn(index) for every entity within radius of (x, z).
+    template <typename Fn>
+    void queryRadius(float x, float z, float radius, Fn &&fn) const;
+
+    // Closest entity accepted by filter(index) within maxRadius, or kNone.
+    // Searches rings of cells outward and stops once no closer cell remains.
+    template <typename Filter>
+    uint32_t nearest(float x, float z, float maxRadius, Filter &&filter, float &outDist2) const;
+
+    // Walks the XZ projection of the ray o + d*t, t in [0, maxDist], cell by cell
+    // (2D DDA) and calls fn(index, tCell) for entities whose centers may lie within
+    // pad of it, where tCell is the ray parameter at which that cell was reached.
+    // Every entity is reported at most once; fn returns false to stop early.
+    template <typename Fn>
+    void traceRay(float ox, float oz, float dx, float dz, float maxDist, float pad, Fn &&fn) const;
+
+private:
+    int cellCoord(float v) const {
+        const int c = static_cast<int>(std::floor((v + half_) * invCell_));
+        return std::max(0, std::min(dim_ - 1, c));
+    }
+    uint32_t cellIndex(int cx, int cz) const { return static_cast<uint32_t>(cz * dim_ + cx); }
+    void link(uint32_t index, uint32_t cell);
+    void unlink(uint32_t index);
+
+    template <typename Fn>
+    bool visitCell(uint32_t cell, float t, Fn &fn) const;
+
+    float half_ = 0.0f;
+    float cellSize_ = 1.0f;
+    float invCell_ = 1.0f;
+    int dim_ = 0;
+    std::vector<uint32_t> head_;   // per cell: first entity
+    std::vector<uint32_t> next_;   // per entity
+    std::vector<uint32_t> prev_;   // per entity
+    std::vector<uint32_t> cell_;   // per entity: current cell or kNone
+    std::vector<float> x_;
+    std::vector<float> z_;
+    mutable std::vector<uint32_t> cellStamp_;
+    mutable uint32_t stamp_ = 0;
+};
+
+template <typename Fn>
+void SpatialGrid::queryRadius(float x, float z, float radius, Fn &&fn) const {
+    if (dim_ == 0) return;
+    const float r2 = radius * radius;
+    const int x0 = cellCoord(x - radius), x1 = cellCoord(x + radius);
+    const int z0 = cellCoord(z - radius), z1 = cellCoord(z + radius);
+    for (int cz = z0; cz <= z1; ++cz) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            for (uint32_t i = head_[cellIndex(cx, cz)]; i != kNone; i = next_[i]) {
+                const float dx = x_[i] - x;
+                const float dz = z_[i] - z;
+                if (dx * dx + dz * dz <= r2) fn(i);
+            }
+        }
+    }
+}
+
+template <typename Filter>
+uint32_t SpatialGrid::nearest(float x, float z, float maxRadius, Filter &&filter, float &outDist2) const {
+    uint32_t best = kNone;
+    float bestDist2 = maxRadius * maxRadius;
+    if (dim_ == 0) return best;
+    const int cx = cellCoord(x), cz = cellCoord(z);
+    const int maxRing = std::min(dim_, static_cast<int>(std::ceil(maxRadius * invCell_)) + 1);
+    for (int ring = 0; ring <= maxRing; ++ring) {
+        // Every cell of this ring is at least (ring - 1) cells from the query point.
+        const float ringMin = static_cast<float>(ring - 1) * cellSize_;
+        if (ring > 0 && ringMin > 0.0f && ringMin * ringMin >= bestDist2) break;
+        for (int oz = -ring; oz <= ring; ++oz) {
+            const int z2 = cz + oz;
+            if (z2 < 0 || z2 >= dim_) continue;
+            const bool edgeRow = oz == -ring || oz == ring;
+            for (int ox = -ring; ox <= ring; ox += edgeRow ? 1 : 2 * ring) {
+                const int x2 = cx + ox;
+                if (x2 >= 0 && x2 < dim_) {
+                    for (uint32_t i = head_[cellIndex(x2, z2)]; i != kNone; i = next_[i]) {
+                        const float dx = x_[i] - x;
+                        const float dz = z_[i] - z;
+                        const float d2 = dx * dx + dz * dz;
+                        if (d2 < bestDist2 && filter(i)) {
+                            bestDist2 = d2;
+                            best = i;
+                        }
+                    }
+                }
+                if (ring == 0) break;
+            }
+        }
+    }
+    outDist2 = bestDist2;
+    return best;
+}
+
+template <typename Fn>
+bool SpatialGrid::visitCell(uint32_t cell, float t, Fn &fn) const {
+    if (cellStamp_[cell] == stamp_) return true;
+    cellStamp_[cell] = stamp_;
+    for (uint32_t i = head_[cell]; i != kNone; i = next_[i]) {
+        if (!fn(i, t)) return false;
+    }
+    return true;
+}
+
+template <typename Fn>
+void SpatialGrid::traceRay(float ox, float oz, float dx, float dz, float maxDist, float pad, Fn &&fn) const {
+    if (dim_ == 0) return;
+    if (++stamp_ == 0) {
+        std::fill(cellStamp_.begin(), cellStamp_.end(), 0u);
+        stamp_ = 1;
+    }
+    const int reach = static_cast<int>(std::ceil(pad * invCell_));
+    int cx = cellCoord(ox), cz = cellCoord(oz);
+    const int stepX = dx > 0.0f ? 1 : -1;
+    const int stepZ = dz > 0.0f ? 1 : -1;
+    const float inf = std::numeric_limits<float>::infinity();
+    const float tDeltaX = dx != 0.0f ? cellSize_ / std::fabs(dx) : inf;
+    const float tDeltaZ = dz != 0.0f ? cellSize_ / std::fabs(dz) : inf;
+    const float cellMinX = static_cast<float>(cx) * cellSize_ - half_;
+    const float cellMinZ = static_cast<float>(cz) * cellSize_ - half_;
+    float tMaxX = dx > 0.0f ? (cellMinX + cellSize_ - ox) / dx : dx < 0.0f ? (cellMinX - ox) / dx : inf;
+    float tMaxZ = dz > 0.0f ? (cellMinZ + cellSize_ - oz) / dz : dz < 0.0f ? (cellMinZ - oz) / dz : inf;
+    float t = 0.0f;
+    for (;;) {
+        for (int nz = std::max(0, cz - reach); nz <= std::min(dim_ - 1, cz + reach); ++nz) {
+            for (int nx = std::max(0, cx - reach); nx <= std::min(dim_ - 1, cx + reach); ++nx) {
+                if (!visitCell(cellIndex(nx, nz), t, fn)) return;
+            }
+        }
+        if (tMaxX < tMaxZ) {
+            t = tMaxX;
+            cx += stepX;
+            tMaxX += tDeltaX;
+        } else {
+            t = tMaxZ;
+            cz += stepZ;
+            tMaxZ += tDeltaZ;
+        }
+        if (t > maxDist || cx < 0 || cx >= dim_ || cz < 0 || cz >= dim_) return;
+    }
+}
+
+#endif
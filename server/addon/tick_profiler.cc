@@ -0,0 +1,93 @@
+#include "tick_profiler.h"
+
+#include <algorithm>
+
+namespace {
+int highestBit(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(v);
+#else
+    int bit = 0;
+    while (v >>= 1) ++bit;
+    return bit;
+#endif
+}
+} // namespace
+
+size_t LatencyHistogram::bucketFor(uint64_t ns) {
+    constexpr uint64_t kSub = 1ull << kSubBits;
+    if (ns < kSub) return static_cast<size_t>(ns);
+    const int msb = highestBit(ns);
+    if (msb >= kMaxBits) return kBuckets - 1;
+    const int shift = msb - kSubBits;
+    return (static_cast<size_t>(shift + 1) << kSubBits) + static_cast<size_t>((ns >> shift) - kSub);
+}
+
+uint64_t LatencyHistogram::bucketUpper(size_t bucket) {
+    constexpr uint64_t kSub = 1ull << kSubBits;
+    if (bucket < kSub) return bucket;
+    const int shift = static_cast<int>(bucket >> kSubBits) - 1;
+    const uint64_t lower = ((bucket & (kSub - 1)) + kSub) << shift;
+    return lower + (1ull << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t ns) {
+    std::atomic<uint64_t> &bucket = counts_[bucketFor(ns)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    count_.store(count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sum_.store(sum_.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+    if (ns > max_.load(std::memory_order_relaxed)) max_.store(ns, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::reset() {
+    for (auto &c : counts_) c.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    const uint64_t total = count();
+    if (total == 0) return 0;
+    // Rank of the wanted sample, 1-based, clamped into [1, total].
+    const double wanted = std::max(1.0, std::min(static_cast<double>(total), p * static_cast<double>(total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += counts_[i].load(std::memory_order_relaxed);
+        if (static_cast<double>(seen) >= wanted) return std::min(bucketUpper(i), max());
+    }
+    return max();
+}
+
+const char *tickPhaseName(TickPhase phase) {
+    switch (phase) {
+    case TickPhase::Input:
+        return "input";
+    case TickPhase::Bots:
+        return "bots";
+    case TickPhase::Simulate:
+        return "simulate";
+    case TickPhase::Snapshot:
+        return "snapshot";
+    case TickPhase::Total:
+        return "total";
+    }
+    return "unknown";
+}
+
+void TickProfiler::reset() {
+    for (auto &h : phases_) h.reset();
+    startLag_.reset();
+    skippedTicks_.store(0, std::memory_order_relaxed);
+    ticks_.store(0, std::memory_order_relaxed);
+    overruns_.store(0, std::memory_order_relaxed);
+    inputsProcessed_.store(0, std::memory_order_relaxed);
+    inputsDropped_.store(0, std::memory_order_relaxed);
+    snapshotBytes_.store(0, std::memory_order_relaxed);
+}
+
+void TickProfiler::endTick(uint64_t totalNs, uint64_t budgetNs) {
+    record(TickPhase::Total, totalNs);
+    bump(ticks_, 1);
+    if (totalNs > budgetNs) bump(overruns_, 1);
+}
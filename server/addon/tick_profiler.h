@@ -0,0 +1,101 @@
+#ifndef TICK_PROFILER_H
+#define TICK_PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Log-linear latency histogram in the style of HdrHistogram. Values below
+// 2^kSubBits ns are exact; each power of two above that is split into
+// 2^kSubBits buckets, so any reported value is within ~3% of the true one.
+// Values past ~18 minutes land in the last bucket. One thread records; any
+// thread may read, and sees counts that trail the writer by at most a sample.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBits = 5;
+    static constexpr int kMaxBits = 40;
+    static constexpr size_t kBuckets = static_cast<size_t>(kMaxBits - kSubBits + 1) << kSubBits;
+
+    void record(uint64_t ns);
+    void reset();
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+    // Upper edge of the bucket holding the p-th value (p in [0, 1]), capped at max().
+    uint64_t percentile(double p) const;
+
+    static size_t bucketFor(uint64_t ns);
+    static uint64_t bucketUpper(size_t bucket);
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> counts_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+enum class TickPhase : uint8_t {
+    Input = 0,    // draining the input ring
+    Bots = 1,     // updateBots
+    Simulate = 2, // respawns, idle integration, timeouts
+    Snapshot = 3, // buildSnapshot
+    Total = 4,
+};
+
+constexpr size_t kTickPhaseCount = 5;
+
+const char *tickPhaseName(TickPhase phase);
+
+// Always-on per-tick instrumentation for one GameServer. The tick thread
+// writes everything except inputsDropped, which any input producer may bump,
+// and the start lag and skip counts, which belong to the scheduler.
+class TickProfiler {
+public:
+    using clock = std::chrono::steady_clock;
+
+    static uint64_t now() {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count());
+    }
+
+    void reset();
+    void record(TickPhase phase, uint64_t ns) { phases_[static_cast<size_t>(phase)].record(ns); }
+    // Closes a tick that took totalNs against a budget of budgetNs.
+    void endTick(uint64_t totalNs, uint64_t budgetNs);
+    void addInputs(uint32_t count) { bump(inputsProcessed_, count); }
+    void addSnapshotBytes(uint32_t bytes) { bump(snapshotBytes_, bytes); }
+    // Written by whoever schedules the ticks, one thread at a time.
+    void recordStartLag(uint64_t ns) { startLag_.record(ns); }
+    void addSkipped(uint32_t ticks) { bump(skippedTicks_, ticks); }
+    void dropInput() { inputsDropped_.fetch_add(1, std::memory_order_relaxed); }
+
+    const LatencyHistogram &phase(TickPhase phase) const { return phases_[static_cast<size_t>(phase)]; }
+    // How far after its deadline each tick started.
+    const LatencyHistogram &startLag() const { return startLag_; }
+    uint64_t skippedTicks() const { return skippedTicks_.load(std::memory_order_relaxed); }
+    uint64_t ticks() const { return ticks_.load(std::memory_order_relaxed); }
+    uint64_t overruns() const { return overruns_.load(std::memory_order_relaxed); }
+    uint64_t inputsProcessed() const { return inputsProcessed_.load(std::memory_order_relaxed); }
+    uint64_t inputsDropped() const { return inputsDropped_.load(std::memory_order_relaxed); }
+    uint64_t snapshotBytes() const { return snapshotBytes_.load(std::memory_order_relaxed); }
+
+private:
+    // Single-writer increment; avoids a locked RMW on the tick thread.
+    static void bump(std::atomic<uint64_t> &counter, uint64_t by) {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    std::array<LatencyHistogram, kTickPhaseCount> phases_;
+    LatencyHistogram startLag_;
+    std::atomic<uint64_t> skippedTicks_{0}; // tick slots given up by the catch-up policy
+    std::atomic<uint64_t> ticks_{0};
+    std::atomic<uint64_t> overruns_{0}; // ticks whose total exceeded the tick budget
+    std::atomic<uint64_t> inputsProcessed_{0};
+    std::atomic<uint64_t> inputsDropped_{0}; // refused by an input lane or rate limit
+    std::atomic<uint64_t> snapshotBytes_{0};
+};
+
+#endif
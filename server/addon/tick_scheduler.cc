@@ -0,0 +1,129 @@
+#include "tick_scheduler.h"
+
+#include <thread>
+
+#if defined(__linux__)
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace {
+inline void cpuRelax() {
+#if defined(__SSE2__) || defined(_M_X64)
+    _mm_pause();
+#endif
+}
+} // namespace
+
+uint32_t TickSchedule::advance(const SchedulerConfig &config, TickClock::time_point now) {
+    const TickClock::time_point next = deadline + period;
+    if (next > now) {
+        burst = 0;
+        deadline = next;
+        return 0;
+    }
+    // Slots [next, now] are already due.
+    const uint32_t due = static_cast<uint32_t>((now - next) / period) + 1;
+    switch (config.catchUp) {
+    case TickCatchUp::Burst:
+        ++burst;
+        deadline = next;
+        return 0;
+    case TickCatchUp::BurstLimit:
+        if (burst < config.burstLimit) {
+            ++burst;
+            deadline = next;
+            return 0;
+        }
+        break;
+    case TickCatchUp::Drop:
+        break;
+    case TickCatchUp::SlowMotion:
+        burst = 0;
+        deadline = now;
+        return 0;
+    }
+    burst = 0;
+    deadline = next + period * due;
+    return due;
+}
+
+TickWaiter::TickWaiter(const SchedulerConfig &config) : config_(config) {
+#if defined(__linux__)
+    if (config_.wait == TickWait::TimerFd) {
+        timerFd_ = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    }
+#endif
+    if (config_.wait == TickWait::TimerFd && timerFd_ < 0) config_.wait = TickWait::Hybrid;
+}
+
+TickWaiter::~TickWaiter() {
+#if defined(__linux__)
+    if (timerFd_ >= 0) close(timerFd_);
+#endif
+}
+
+void TickWaiter::waitUntil(TickClock::time_point deadline) {
+    switch (config_.wait) {
+    case TickWait::Sleep:
+        std::this_thread::sleep_until(deadline);
+        return;
+    case TickWait::Hybrid:
+        hybridWaitUntil(deadline, config_.spinWindow);
+        return;
+    case TickWait::TimerFd:
+        break;
+    }
+#if defined(__linux__)
+    // steady_clock is CLOCK_MONOTONIC on Linux, so its epoch works as an absolute expiry.
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    if (ns <= 0) return;
+    itimerspec spec{};
+    spec.it_value.tv_sec = static_cast<time_t>(ns / 1000000000);
+    spec.it_value.tv_nsec = static_cast<long>(ns % 1000000000);
+    if (timerfd_settime(timerFd_, TFD_TIMER_ABSTIME, &spec, nullptr) != 0) {
+        std::this_thread::sleep_until(deadline);
+        return;
+    }
+    uint64_t expirations = 0;
+    // read() returns once the timer fires (immediately for a past deadline).
+    while (read(timerFd_, &expirations, sizeof(expirations)) < 0 && TickClock::now() < deadline) {
+    }
+#endif
+}
+
+void hybridWaitUntil(TickClock::time_point deadline, TickClock::duration spin) {
+    const TickClock::time_point wake = deadline - spin;
+    if (TickClock::now() < wake) std::this_thread::sleep_until(wake);
+    while (TickClock::now() < deadline) cpuRelax();
+}
+
+const char *tickWaitName(TickWait wait) {
+    switch (wait) {
+    case TickWait::Sleep:
+        return "sleep";
+    case TickWait::Hybrid:
+        return "hybrid";
+    case TickWait::TimerFd:
+        return "timerfd";
+    }
+    return "unknown";
+}
+
+const char *tickCatchUpName(TickCatchUp catchUp) {
+    switch (catchUp) {
+    case TickCatchUp::Burst:
+        return "burst";
+    case TickCatchUp::BurstLimit:
+        return "burstLimit";
+    case TickCatchUp::Drop:
+        return "drop";
+    case TickCatchUp::SlowMotion:
+        return "slowMotion";
+    }
+    return "unknown";
+}
@@ -0,0 +1,63 @@
+#ifndef TICK_SCHEDULER_H
+#define TICK_SCHEDULER_H
+
+#include <chrono>
+#include <cstdint>
+
+// How a tick thread waits for the next tick start.
+enum class TickWait : uint8_t {
+    Sleep = 0,  // sleep_until the deadline; wakeup jitter is the OS timer slack
+    Hybrid = 1, // sleep until spinWindow before the deadline, then spin
+    TimerFd = 2, // absolute CLOCK_MONOTONIC timerfd (Linux; Hybrid elsewhere)
+};
+
+// What to do once a tick starts so late that the next one is already due.
+enum class TickCatchUp : uint8_t {
+    Burst = 0,      // run every missed tick back to back
+    BurstLimit = 1, // run up to burstLimit back to back, then skip to the next slot
+    Drop = 2,       // skip missed slots; stay on the original tick grid
+    SlowMotion = 3, // never skip; shift the grid so game time falls behind wall time
+};
+
+struct SchedulerConfig {
+    TickWait wait = TickWait::Sleep;
+    TickCatchUp catchUp = TickCatchUp::BurstLimit;
+    uint32_t burstLimit = 3;
+    std::chrono::microseconds spinWindow{500};
+};
+
+using TickClock = std::chrono::steady_clock;
+
+// Per-room state for the catch-up policy.
+struct TickSchedule {
+    TickClock::time_point deadline; // start time of the tick about to run
+    TickClock::duration period{};
+    uint32_t burst = 0; // consecutive late ticks run back to back
+
+    // Moves deadline past a tick that has just finished at now. Returns the
+    // number of tick slots skipped.
+    uint32_t advance(const SchedulerConfig &config, TickClock::time_point now);
+};
+
+// Blocks a dedicated tick thread until a deadline using the configured wait.
+class TickWaiter {
+public:
+    explicit TickWaiter(const SchedulerConfig &config);
+    ~TickWaiter();
+    TickWaiter(const TickWaiter &) = delete;
+    TickWaiter &operator=(const TickWaiter &) = delete;
+
+    void waitUntil(TickClock::time_point deadline);
+
+private:
+    SchedulerConfig config_;
+    int timerFd_ = -1;
+};
+
+// Sleeps until spin before the deadline, then busy-waits for the rest.
+void hybridWaitUntil(TickClock::time_point deadline, TickClock::duration spin);
+
+const char *tickWaitName(TickWait wait);
+const char *tickCatchUpName(TickCatchUp catchUp);
+
+#endif
@@ -5,10 +5,81 @@ const addonPath = path.join(__dirname, "../addon/build/Release/addon.node");
 // eslint-disable-next-line @typescript-eslint/no-var-requires
 const native: any = require(addonPath);
 
+export interface SnapshotBits {
+  position?: number;
+  velocity?: number;
+  yaw?: number;
+  pitch?: number;
+}
+
 export interface GameConfig {
   maxPlayers: number;
   worldHalfExtent: number;
   botCount: number;
+  snapshotBits?: SnapshotBits;
+  tickRate?: number; // Hz, default 60
+  inputBufferDepth?: number; // jitter buffer: commands queued per player before the first is applied, default 1
+  maxRewindTicks?: number; // lag compensation: shots rewind targets to the shooter's acked tick, at most this far (default 12, max 31, 0 disables)
+  seed?: number; // room RNG seed (shot spread, respawns); default random, logged when recording
+  mapPath?: string; // binary map written by client/scripts/exportMap.ts, whose extent overrides worldHalfExtent; throws if unreadable
+  recordPath?: string; // append every queued input and per-tick state hashes here, for replayInputLog
+  interestRadius?: number; // each client is sent only players within this distance; default 0 sends everyone
+  interestMargin?: number; // hysteresis: a player leaves a client's set only beyond interestRadius + this, default 5
+  inputRate?: number; // commands/s admitted per player, default 120; 0 disables the limit
+  inputBurst?: number; // commands a player may send at once, default 60
+  scheduler?: SchedulerOptions;
+}
+
+// Defaults: sleep, burstLimit 3, 500 us spin.
+export interface SchedulerOptions {
+  wait?: "sleep" | "hybrid" | "timerfd";
+  catchUp?: "burst" | "burstLimit" | "drop" | "slowMotion";
+  burstLimit?: number;
+  spinUs?: number; // hybrid: sleep until this long before the tick, then spin
+}
+
+// Opaque handle from createRoom; 0 is never a valid room.
+export type RoomHandle = number;
+
+export interface PhaseStats {
+  count: number;
+  mean: number; // all latencies in ns
+  p50: number;
+  p99: number;
+  p999: number;
+  max: number;
+}
+
+export interface PlayerInputStats {
+  id: number;
+  buffered: number; // commands waiting in the jitter buffer
+  underruns: number;
+  overflows: number; // oldest commands dropped to keep the buffer bounded
+  duplicates: number;
+  late: number; // arrived after a newer command was applied
+  rateLimited: number; // over the player's inputRate
+  laneFull: number; // refused because the producer's input lane was full
+}
+
+export interface ReplayResult {
+  ticks: number;
+  inputs: number;
+  mismatches: number; // ticks whose state hash differed from the recording
+  firstMismatchTick: number; // 0 if none
+  seconds: number;
+}
+
+export interface TickStats {
+  ticks: number;
+  overruns: number; // ticks that took longer than 1 / tickRate
+  inputsProcessed: number;
+  inputsDropped: number; // input ring full
+  snapshotBytes: number;
+  phases: Record<"input" | "bots" | "simulate" | "snapshot" | "total", PhaseStats>;
+  startLag: PhaseStats; // tick start minus its deadline
+  skippedTicks: number; // given up by the catch-up policy
+  players: PlayerInputStats[]; // humans only, refreshed every 30 ticks
+  pool: { rooms: number; workers: number; ticks: number; lateTicks: number; maxLateNs: number; skippedTicks: number };
 }
 
 class GameBridge {
@@ -26,13 +97,40 @@ class GameBridge {
     this.started = false;
   }
 
-  pushInput(playerId: number, buffer: Buffer) {
-    return native.pushInput(playerId, buffer);
+  // Extra rooms share the native worker pool with the default room. Calls
+  // below without a room act on the default room started by start().
+  createRoom(config: GameConfig): RoomHandle {
+    return native.createRoom(config);
+  }
+
+  destroyRoom(room: RoomHandle): boolean {
+    return native.destroyRoom(room);
+  }
+
+  // One N-API call per packet, parsed in addon.cc.
+  pushInput(playerId: number, buffer: Uint8Array, room?: RoomHandle): boolean {
+    return native.pushInput(playerId, buffer, room);
+  }
+
+  // Borrowed view of the latest native frame; read-only, do not mutate.
+  // With a client id this is that client's delta against its last acked tick.
+  getSnapshot(clientId?: number, room?: RoomHandle): ArrayBuffer {
+    return native.getSnapshot(clientId, room);
+  }
+
+  forgetClient(clientId: number, room?: RoomHandle) {
+    native.forgetClient(clientId, room);
+  }
+
+  // Re-runs a room recorded with recordPath, blocking; null if the log can't be read
+  // or was recorded by a build with an older log version.
+  replayInputLog(path: string): ReplayResult | null {
+    return native.replayInputLog(path);
   }
 
-  getSnapshot(): Buffer {
-    const buf: ArrayBuffer = native.getSnapshot();
-    return Buffer.from(buf);
+  // Cumulative since the room started; null for an unknown room.
+  getStats(room?: RoomHandle): TickStats | null {
+    return native.getStats(room);
   }
 }
 
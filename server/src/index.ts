@@ -1,10 +1,17 @@
+import path from "path";
 import { gameBridge } from "./game";
 import { NetServer } from "./net";
 
 const port = Number(process.env.PORT || 8080);
 
-// City block footprint (perimeter only; see client/src/map.ts for layout).
-gameBridge.start({ maxPlayers: 64, worldHalfExtent: 50, botCount: 0 });
+// City block footprint (perimeter only), exported from client/src/map.ts by `npm run export:map` there.
+gameBridge.start({
+  maxPlayers: 64,
+  worldHalfExtent: 50,
+  botCount: 0,
+  interestRadius: 35,
+  mapPath: path.join(__dirname, "../maps/city.bfmap"),
+});
 const net = new NetServer();
 net.start(port);
 
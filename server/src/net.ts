@@ -4,6 +4,7 @@ import { gameBridge } from "./game";
 interface ClientInfo {
   id: number;
   socket: WebSocket;
+  lastSent: ArrayBuffer | null;
 }
 
 export class NetServer {
@@ -18,14 +19,15 @@ export class NetServer {
 
     this.wss.on("connection", (ws) => this.handleConnection(ws));
 
-    // Poll snapshots at 60 Hz and broadcast
+    // Poll snapshots at 60 Hz; each client gets its own delta-encoded frame
     this.snapshotTimer = setInterval(() => {
-      const snap = gameBridge.getSnapshot();
-      if (!snap || snap.length === 0) return;
       for (const client of this.clients.values()) {
-        if (client.socket.readyState === WebSocket.OPEN) {
-          client.socket.send(snap);
-        }
+        if (client.socket.readyState !== WebSocket.OPEN) continue;
+        const snap = gameBridge.getSnapshot(client.id);
+        // The addon hands back the same buffer until a new tick is published
+        if (!snap || snap.byteLength === 0 || snap === client.lastSent) continue;
+        client.lastSent = snap;
+        client.socket.send(snap);
       }
     }, 1000 / 60);
 
@@ -45,7 +47,7 @@ export class NetServer {
 
   private handleConnection(ws: WebSocket) {
     const id = this.nextId++;
-    const info: ClientInfo = { id, socket: ws };
+    const info: ClientInfo = { id, socket: ws, lastSent: null };
     this.clients.set(ws, info);
 
     // Handshake: small JSON for player id, not in hot path
@@ -58,6 +60,7 @@ export class NetServer {
 
     ws.on("close", () => {
       this.clients.delete(ws);
+      gameBridge.forgetClient(id);
     });
 
     ws.on("error", (err) => {